@@ -36,7 +36,6 @@
 	- ...
 	- try to change vector and function definition syntax
 	- add default user val (GYS_user_val)?
-	- add hash table instead of map (STLport)
 	- putback linenum too for better error tracing?
 	- don't force user to write type-funcs for every type
 	- write wrapper for classes and functions
@@ -58,6 +57,32 @@
   	- fixed: project settings
 	- fixed: std interpreter code
 	- fixed: main.gys code
+	- added: token array mode (GYS_PRETOKENIZE) - every token is lexed only once
+	- added: delimeter codes (GYS_delim), expression analyzer doesn't compare strings anymore
+	- added: compiled mode (GYS_COMPILE) - expressions are compiled into trees on the first pass
+	- added: bytecode and its virtual machine (GYS_COMPILE mode), compilers of built-in functions (loops become jumps)
+	- added: stdGYS interpreter switch --dump-bytecode
+	- added: GYS::move_to_odd() - skipped code is remembered in GYS_PRETOKENIZE mode (untaken branches and loop exits are skipped at once)
+	- added: type ids (GYS_type_id) - values, operators and converters keep ids instead of typenames
+	- changed: operators and converters are found in dense dispatch tables (operator code x type id) instead of maps
+	- added: GYS_ret_val::set_small_val() - bool, char, int and double values are stored without GYS_user_val allocation
+	- changed: sub-scripts (function calls, import(), run()...) share the language definition (GYS_language) instead of copying it (function():thread gets its own copy, its calls don't share GYS_source)
+	- added: GYS::begin_call(), GYS::end_call(), GYS::add_arg_var() - sub-scripts of script function calls are reused
+	- added: GYS_source - code of many calls is lexed and compiled once in GYS_PRETOKENIZE mode
+	- changed: variables are resolved once (references are kept by token index and in bytecode till names of the variable maps change)
+	- changed: functions, types and variables are kept in hash tables (GYS_hash_map), the lexer hashes names while reading them
+	- added: inline caches of operators, converters and built-in functions in the bytecode (GYS_inline_cache)
+	- added: GYS::add_quick_binary_op(), GYS::add_quick_post_unary_op() - compiled operators are quickened for the operand types
+	- added: optimizer passes of the bytecode (GYS_OPT_FOLD, GYS_OPT_BRANCH, GYS_OPT_HOIST), GYS::add_pure_gys_func()
+	- added: GYS_OPT_INLINE - sub-scripts of small function calls stay bound to the function body (arguments are put into the same variables)
+	- added: GYS_OPT_TAIL_CALL - tail calls "return f(...)" are made by the caller in the same call frame (GYS::set_tail_call(), GYS::get_tail_call())
+	- changed: stdGYS vectors share their elements between copies (copy-on-write), size(), empty(), front(), back() don't copy them
+	- changed: stdGYS vectors of bool, char, int, double keep unboxed elements (GYS_vector_data), v[i] is changed through a proxy lvalue (GYS_user_val::lvalue_changed(), GYS_user_val::lvalue_read()), compiled reads of v[i] (GYS_OP_VALUE) don't make it
+	- added: stdGYS element-wise functions of int and double vectors vadd(), vsub(), vmul(), vdiv(), vless(), vgreater(), vless_eq(), vgreater_eq(), vequal(), vnot_equal() (GYS_vector_val::elementwise()), their arguments are read by GYS::get_any_val()
+	- added: stdGYS reductions of int and double vectors vsum(), vmean(), vvariance(), vmin(), vmax(), vargmin(), vargmax(), vdot() - sums are computed pairwise (GYS_vector_val::reduce(), GYS_vector_val::dot())
+	- changed: stdGYS range operator vector(low~up) returns a slice which refers to the elements of the vector till one of them is changed (GYS_vector_val::slice())
+	- added: stdGYS matrix type (GYS_matrix_val) - elements of double are kept row by row in one vector, cache-blocked matrix product and transpose, mrows(), mcols(), mset(), mtranspose(), mscale(), mmul_elems(), mdiv_elems(), mrow_sums(), mcol_sums(), mrow_means(), mcol_means()
+	- changed: stdGYS string += appends in place if the variable is the only owner of its string (building a string of N pieces isn't O(N^2) anymore)
 
 <hr>
 */
@@ -117,7 +142,11 @@ Mainly this library can be used to create:
 %GYS has built-in lexical and expression analyzer, but during interpretation it calls different user code
 for executing commands, operators, conversions and value getting.
 The interpreter is fully runtime - it reads code and interprets it at once. 
-It doesn't generate any intermediate code.
+It doesn't generate any intermediate code by default.
+In GYS_COMPILE mode every expression is recorded into a tree while it's interpreted for the first time
+and the next passes run the bytecode compiled from the tree (the same user callbacks are called).
+Built-in functions can have compilers too (see GYS::add_gys_func_compiler(), GYS_compiler),
+e.g. stdGYS loops are compiled into jumps.
 
   \section restricts Restrictions
 
@@ -133,6 +162,25 @@ Some language definition elements are built-in and can't be changed by user yet:
 #include "gys.h"
 
 GYS::GYS_var_map GYS::global_var_map; // static member must be defined
+unsigned long GYS_generation::last_gen=0;
+GYS_generation GYS::global_var_gen;
+
+// delimeters in GYS_delim order
+static const char* gys_delim_texts[GYS_DELIM_NUM]={
+	"",
+	";", ":", ",", "(", ")", "{", "}", "[", "]", "<", ">", "=", "+", "-", "*", "&", "|", "!", "%", "^", "#", "~", ".", "/",
+	"==", "!=", "===", "!==", "<=", ">=", ":=", "+=", "-=", "*=", "/=", "%=", "<<=", ">>=", "<<", ">>", "++", "--", "&&", "||", "->"
+};
+
+// one-char delimeters, position+1 is the code
+static const char* gys_delim_chars=";:,(){}[]<>=+-*&|!%^#~./";
+
+// precedence of binary operators in GYS_delim order (see get_val()), -1 - not a binary operator
+static const int gys_binary_prec[GYS_DELIM_NUM]={
+	-1,
+	-1, -1, -1, -1, -1, -1, -1,  0, -1,  5,  5,  1,  7,  7,  8, -1, -1, -1,  8, -1, -1, -1, -1,  8,
+	 4,  4,  4,  4,  5,  5,  1,  1,  1,  1,  1,  1,  1,  1,  6,  6, -1, -1,  3,  2, -1
+};
 
 GYS::GYS(string name_str, string return_type, istream* in) : name(name_str)
 {
@@ -145,6 +193,9 @@ void GYS::init()
 {
 	token="";
 	tok_type=GYS_EOF;
+	tok_code=GYS_NO_DELIM;
+	tok_id=-1;
+	tok_hash=0;
 	tok_val=0;
 
 	line_num=1;
@@ -153,26 +204,47 @@ void GYS::init()
 
 	is_putbacked=false;
 
-	//clearing all the maps
-	func_map.clear();
-	type_func_map.clear();
+	tok_buf=0;
+	tok_pos=0;
+	tok_cur=0;
+	tok_offset=-1;
+
+	vm_depth=0;
+
+	//clearing all the maps (converters are kept)
+	GYS_language* new_lang=new GYS_language;
+	if(lang)
+		new_lang->converter_table=lang->converter_table;
+	lang=new_lang;
+
 	var_map.clear();
-	binary_op_map.clear();
-	post_unary_op_map.clear();
-	pre_unary_op_map.clear();
+	var_gen.next();
 
 	ret_type=gys_void_type;
 	ret_val=GYS_ret_val();
 
 	was_finished=false;
 
+	tail_calls=false;
+	tail_pending=false;
+
+	other_thread=false;
+
 	warning_func=0;
 	error_func=0;
 	fatal_error_func=0;
 
 	super_script=0;
 
-	flags.set(); // enable everything
+	// default options
+	flags.reset();
+	flags.set(GYS_ESC);
+	flags.set(GYS_GLOBAL_VAR_OP);
+	flags.set(GYS_OPT_FOLD);
+	flags.set(GYS_OPT_BRANCH);
+	flags.set(GYS_OPT_HOIST);
+	flags.set(GYS_OPT_INLINE);
+	flags.set(GYS_OPT_TAIL_CALL);
 }
 
 void GYS::set_name(string name_str)
@@ -195,27 +267,27 @@ void GYS::interp_next()
 	if(!was_finished)
 	if(tok_type==GYS_NAME)
 	{	
-		if(is_func(token))     // built-in func
+		GYS_var_ref var;
+
+		if(lang->func_map.find(token, tok_hash)!=lang->func_map.end()) // built-in func
 		{
 			putback_tok();
 			get_expr_1(gys_void_type);
 		}
-		else                        // local or global var...
+		else if(find_var(token, tok_hash, var)) // local or global var...
 		{
-			GYS_ret_val* val=get_var(token);
-			if(val) // check for var existence
-			{
-				putback_tok();
-				get_expr_1(val->get_type_name());
-			}
+			putback_tok();
+			get_expr_1(var.cell()->first.get_type_name());
 		}
+		else
+			error("Unknown variable: ", token);
 	}
-	else if(tok_type==GYS_DELIMETER && token=="(")
+	else if(tok_code==GYS_LPAREN)
 	{
 		putback_tok();
 		get_expr_1(gys_void_type);
 	}
-	else if( !(tok_type==GYS_DELIMETER && token==";") && tok_type!=GYS_EOF)
+	else if(tok_code!=GYS_SEMICOLON && tok_type!=GYS_EOF)
 	{
 		error("Can't interpret token: ", token);
 	}
@@ -237,7 +309,8 @@ void GYS::finish_script()
 	tok_type=GYS_EOF;
 	was_finished=true;
 
-	if(ret_val.get_type_name()!=ret_type)	
+	if(ret_val.get_type_name()!=ret_type && !tail_pending) // the tail call returns the value
+
 		error("Script must return the value of type ", ret_type);
 }
 
@@ -270,6 +343,16 @@ bool GYS::enable(GYS_flag flag)
 		return false;
 	}
 
+	if(flag==GYS_COMPILE) // compiled expressions refer to the token array
+		flags.set(GYS_PRETOKENIZE);
+
+	if( (flag==GYS_PRETOKENIZE || flag==GYS_COMPILE) && !tok_buf) // new token array from the current input pos
+	{
+		tok_buf=new GYS_token_buf;
+		tok_pos=0;
+		tok_cur=0;
+	}
+
 	return true;
 }
 
@@ -282,6 +365,12 @@ bool GYS::disable(GYS_flag flag)
 		return false;
 	}
 
+	if(flag==GYS_PRETOKENIZE)
+	{
+		flags.set(GYS_COMPILE, false);
+		tok_buf=0;
+	}
+
 	return true;
 }
 
@@ -340,6 +429,15 @@ void GYS::fatal_error(string str1, string str2)
 	finish_script();
 }
 
+GYS_language* GYS::own_lang()
+{
+	if(lang->getRefCnt()>1) // shared with other scripts
+		lang=new GYS_language(*lang);
+
+	lang->gen.next(); // inline caches of the bytecode become invalid
+	return lang;
+}
+
 bool GYS::add_gys_func(string ext_repr, GYS_FUNC_PTR funcPtr)
 {
 	if(is_var(ext_repr))
@@ -348,6 +446,8 @@ bool GYS::add_gys_func(string ext_repr, GYS_FUNC_PTR funcPtr)
 		return false;
 	}
 
+	GYS_func_map& func_map=own_lang()->func_map;
+
 	if(func_map.size()<func_map.max_size())
 	{
 		func_map[ext_repr]=funcPtr;
@@ -361,6 +461,33 @@ bool GYS::add_gys_func(string ext_repr, GYS_FUNC_PTR funcPtr)
 	return true;
 }
 
+bool GYS::add_gys_func_compiler(string ext_repr, GYS_FUNC_COMPILER_PTR pf)
+{
+	if(!is_func(ext_repr))
+	{
+		error("Can't add compiler of built-in GYS-function (function doesn't exist): ", ext_repr);
+		return false;
+	}
+
+	own_lang()->func_compiler_map[ext_repr]=pf;
+
+	return true;
+}
+
+bool GYS::add_pure_gys_func(string ext_repr)
+{
+	if(!is_func(ext_repr))
+	{
+		error("Can't declare pure built-in GYS-function (function doesn't exist): ", ext_repr);
+		return false;
+	}
+
+	GYS_language* l=own_lang();
+	l->pure_func_map[ext_repr]=l->func_map.find(ext_repr)->second; // redefined function isn't pure
+
+	return true;
+}
+
 bool GYS::add_gys_type(string type_str, GYS_TYPE_FUNC_PTR tfuncPtr)
 {
 	if(is_var(type_str))
@@ -369,9 +496,12 @@ bool GYS::add_gys_type(string type_str, GYS_TYPE_FUNC_PTR tfuncPtr)
 		return false;
 	}
 
+	GYS_type_func_map& type_func_map=own_lang()->type_func_map;
+
 	if(type_func_map.size()<type_func_map.max_size())
 	{
 		type_func_map[type_str]=tfuncPtr;	
+		gys_type_id(type_str); // the type gets its id
 	}
 	else
 	{
@@ -384,15 +514,7 @@ bool GYS::add_gys_type(string type_str, GYS_TYPE_FUNC_PTR tfuncPtr)
 
 bool GYS::add_gys_converter(string from_type, string into_type, GYS_CONVERTER_PTR pf)
 {
-	if(converter_map.size()<converter_map.max_size())
-	{
-		converter_map[GYS_converter(from_type, into_type)]=pf;	
-	}
-	else
-	{
-		error("Can't add new GYS-converter (not enough memory): from '"+from_type+"' into ", into_type);
-		return false;
-	}
+	own_lang()->converter_table.set(gys_type_id(from_type), gys_type_id(into_type), pf);
 
 	return true;
 }
@@ -408,14 +530,13 @@ bool GYS::add_binary_op(string opname, string l_type, string r_type, GYS_BINARY_
 		return false;
 	}
 
-	if(binary_op_map.size()<binary_op_map.max_size()) {
-		binary_op_map[GYS_binary_op(opname, l_type)]=make_pair(r_type, pf);
-	}
-	else
-	{
-		error("Can't add new binary operator (not enough memory): ", opname);
-		return false;
-	}
+	GYS_language* l=own_lang();
+	GYS_delim code=gys_delim_code(opname);
+
+	l->binary_op_table.set(code, gys_type_id(l_type), GYS_binary_op(gys_type_id(r_type), pf));
+
+	if(code<(int)l->quick_binary_op_tables.size()) // quick forms of the old operator
+		l->quick_binary_op_tables[code].clear(gys_type_id(l_type));
 
 	return true;
 }
@@ -428,14 +549,8 @@ bool GYS::add_pre_unary_op(string opname, string ret_type, GYS_PRE_UNARY_OP_FUNC
 		return false;
 	}
 
-	if(pre_unary_op_map.size()<pre_unary_op_map.max_size()) {		
-		pre_unary_op_map[GYS_pre_unary_op(opname, ret_type)]=pf;
-	}
-	else
-	{
-		error("Can't add new prefix unary operator (not enough memory): ", opname);
-		return false;
-	}
+	own_lang()->pre_unary_op_table.set(gys_delim_code(opname), gys_type_id(ret_type), pf);
+
 	return true;
 }
 
@@ -447,14 +562,47 @@ bool GYS::add_post_unary_op(string opname, string l_type, GYS_POST_UNARY_OP_FUNC
 		return false;
 	}
 
-	if(post_unary_op_map.size()<post_unary_op_map.max_size()) {
-		post_unary_op_map[GYS_post_unary_op(opname, l_type)]=pf;
+	GYS_language* l=own_lang();
+	GYS_delim code=gys_delim_code(opname);
+
+	l->post_unary_op_table.set(code, gys_type_id(l_type), pf);
+	l->quick_post_unary_op_table.set(code, gys_type_id(l_type), 0); // quick form of the old operator
+
+	return true;
+}
+
+bool GYS::add_quick_binary_op(string opname, string l_type, string r_type, GYS_BINARY_OP_FUNC_PTR pf)
+{
+	if(opname=="[]") // fix index operator 
+		opname="[";
+
+	if(!is_binary_op(opname))
+	{
+		error("Can't add quick binary operator (wrong token): ", opname);
+		return false;
 	}
-	else
+
+	GYS_language* l=own_lang();
+	GYS_delim code=gys_delim_code(opname);
+
+	if(code>=(int)l->quick_binary_op_tables.size())
+		l->quick_binary_op_tables.resize(code+1);
+
+	l->quick_binary_op_tables[code].set(gys_type_id(l_type), gys_type_id(r_type), pf);
+
+	return true;
+}
+
+bool GYS::add_quick_post_unary_op(string opname, string l_type, GYS_POST_UNARY_OP_FUNC_PTR pf)
+{
+	if(!is_post_unary_op(opname))
 	{
-		error("Can't add new postfix unary operator (not enough memory): ", opname);
+		error("Can't add quick postfix unary operator (wrong token): ", opname);
 		return false;
 	}
+
+	own_lang()->quick_post_unary_op_table.set(gys_delim_code(opname), gys_type_id(l_type), pf);
+
 	return true;
 }
 
@@ -478,7 +626,10 @@ bool GYS::add_local_var(string vname, GYS_ret_val val)
 	}
 	
 	if(var_map.size()<var_map.max_size())
+	{
 		var_map[vname]=make_pair(val, is_const);
+		var_gen.next();
+	}
 	else
 	{
 		error("Can't add new local variable(not enough memory): ", vname);
@@ -508,7 +659,10 @@ bool GYS::add_global_var(string vname, GYS_ret_val val)
 	}
 	
 	if(global_var_map.size()<global_var_map.max_size())
+	{
 		global_var_map[vname]=make_pair(val, is_const);
+		global_var_gen.next();
+	}
 	else
 	{
 		error("Can't add new global variable(not enough memory): ", vname);
@@ -520,46 +674,149 @@ bool GYS::add_global_var(string vname, GYS_ret_val val)
 
 void GYS::remove_gys_func(string ext_repr)
 {
-	func_map.erase(ext_repr);
+	GYS_language* l=own_lang();
+
+	l->func_map.erase(ext_repr);
+	l->func_compiler_map.erase(ext_repr);
+	l->pure_func_map.erase(ext_repr);
 }
 
 void GYS::remove_gys_type(string type_str)
 {
-	type_func_map.erase(type_str);
+	own_lang()->type_func_map.erase(type_str);
 }
 
 void GYS::remove_gys_converter(string from_type, string into_type)
 {
-	converter_map.erase( GYS_converter(from_type, into_type) );
+	own_lang()->converter_table.set(gys_type_id(from_type), gys_type_id(into_type), 0);
 }
 
 void GYS::remove_binary_op(string opname, string l_type)
 {
-	binary_op_map.erase( GYS_binary_op(opname, l_type) );
+	GYS_delim code=gys_delim_code(opname);
+
+	if(code!=GYS_NO_DELIM)
+	{
+		GYS_language* l=own_lang();
+
+		l->binary_op_table.set(code, gys_type_id(l_type), GYS_binary_op());
+
+		if(code<(int)l->quick_binary_op_tables.size())
+			l->quick_binary_op_tables[code].clear(gys_type_id(l_type));
+	}
 }
 
 void GYS::remove_pre_unary_op(string opname, string ret_type)
 {
-	pre_unary_op_map.erase( GYS_pre_unary_op(opname, ret_type) );
+	GYS_delim code=gys_delim_code(opname);
+
+	if(code!=GYS_NO_DELIM)
+		own_lang()->pre_unary_op_table.set(code, gys_type_id(ret_type), 0);
 }
 
 void GYS::remove_post_unary_op(string opname, string l_type)
 {
-	post_unary_op_map.erase( GYS_post_unary_op(opname, l_type) );
+	GYS_delim code=gys_delim_code(opname);
+
+	if(code!=GYS_NO_DELIM)
+	{
+		GYS_language* l=own_lang();
+
+		l->post_unary_op_table.set(code, gys_type_id(l_type), 0);
+		l->quick_post_unary_op_table.set(code, gys_type_id(l_type), 0);
+	}
+}
+
+void GYS::remove_quick_binary_op(string opname, string l_type, string r_type)
+{
+	GYS_delim code=gys_delim_code(opname);
+
+	if(code!=GYS_NO_DELIM)
+	{
+		GYS_language* l=own_lang();
+
+		if(code<(int)l->quick_binary_op_tables.size())
+			l->quick_binary_op_tables[code].set(gys_type_id(l_type), gys_type_id(r_type), 0);
+	}
+}
+
+void GYS::remove_quick_post_unary_op(string opname, string l_type)
+{
+	GYS_delim code=gys_delim_code(opname);
+
+	if(code!=GYS_NO_DELIM)
+		own_lang()->quick_post_unary_op_table.set(code, gys_type_id(l_type), 0);
 }
 
 void GYS::remove_local_var(string vname)
 {
 	var_map.erase(vname);
+	var_gen.next();
 }
 
 void GYS::remove_global_var(string vname)
 {
 	global_var_map.erase(vname);
+	global_var_gen.next();
 }
 
 GYS_tok_type GYS::get_token()
 {
+	if(tok_buf) // token array mode
+	{
+		GYS_token_buf& buf=*tok_buf;
+
+		if(is_putbacked) // putbacked token was replaced by EOF in finish_script()
+		{
+			is_putbacked=false;
+
+			if(tok_type==GYS_EOF)
+			{
+				tok_pos=tok_cur+1;
+				return tok_type;
+			}
+		}
+
+		if(tok_pos>=(long)buf.toks.size())
+		{
+			if(buf.complete) // EOF again
+				tok_pos=(long)buf.toks.size()-1;
+			else // lex it once
+			{
+				if(!buf.toks.empty()) // lexer continues after the last lexed token
+					line_num=buf.toks.back().line;
+
+				GYS_token t;
+				t.type=lex_token();
+				t.code=tok_code;
+				t.text=buf.intern(token, tok_type==GYS_NAME ? tok_hash : gys_str_hash(token));
+				t.val=tok_val;
+				t.offset=tok_offset;
+				t.line=line_num;
+
+				buf.toks.push_back(t);
+				buf.complete=(t.type==GYS_EOF);
+
+				tok_id=t.text;
+				tok_cur=tok_pos++;
+				return tok_type;
+			}
+		}
+
+		const GYS_token& t=buf.toks[tok_pos];
+
+		token=buf.texts[t.text];
+		tok_type=t.type;
+		tok_code=t.code;
+		tok_id=t.text;
+		tok_hash=buf.text_hashes[t.text];
+		tok_val=t.val;
+		line_num=t.line;
+
+		tok_cur=tok_pos++;
+		return tok_type;
+	}
+
 	// if putbacked - skip this get_token
 	if(is_putbacked)
 	{
@@ -567,9 +824,16 @@ GYS_tok_type GYS::get_token()
 		return tok_type;
 	}
 
+	return lex_token();
+}
+
+GYS_tok_type GYS::lex_token()
+{
 	string str="";
 	char ch;
 
+	tok_code=GYS_NO_DELIM;
+
 	if(!file->get(ch)) // next char or EOF
 	{
 		token="";
@@ -586,6 +850,12 @@ GYS_tok_type GYS::get_token()
 		if(ch=='\n' || ch=='\r') line_num++;  // line number
 	}
 
+	if(tok_buf) // for token array
+	{
+		long pos=file->tellg();
+		tok_offset=pos>0 ? pos-1 : -1;
+	}
+
 	/* delimeters:
 	== += -= *= /= %= != <= >=
 	, ; : ( ) { } [ ] < > + - * / % ! =
@@ -606,10 +876,24 @@ GYS_tok_type GYS::get_token()
 			file->get(ch);
 			token+=ch;
 
-			if( (token=="==" || token=="!=") && file->peek()=='=') // === !==
+			switch(token[0])
+			{
+				case '=': tok_code=GYS_EQUAL;         break;
+				case '+': tok_code=GYS_PLUS_ASSIGN;   break;
+				case '-': tok_code=GYS_MINUS_ASSIGN;  break;
+				case '*': tok_code=GYS_MUL_ASSIGN;    break;
+				case '%': tok_code=GYS_MOD_ASSIGN;    break;
+				case '!': tok_code=GYS_NOT_EQUAL;     break;
+				case '<': tok_code=GYS_LESS_EQ;       break;
+				case '>': tok_code=GYS_GREATER_EQ;    break;
+				case ':': tok_code=GYS_DEF_ASSIGN;    break;
+			}
+
+			if( (tok_code==GYS_EQUAL || tok_code==GYS_NOT_EQUAL) && file->peek()=='=') // === !==
 			{
 				file->get(ch);
 				token+=ch;
+				tok_code= tok_code==GYS_EQUAL ? GYS_IDENT : GYS_NOT_IDENT;
 			}
 
 			return (tok_type=GYS_DELIMETER);
@@ -618,41 +902,48 @@ GYS_tok_type GYS::get_token()
 		{
 			file->get(ch);
 			token="++";
+			tok_code=GYS_INC;
 			return (tok_type=GYS_DELIMETER);
 		}
 		else if(ch=='-' && (file->peek()=='-') ) // --
 		{
 			file->get(ch);
 			token="--";
+			tok_code=GYS_DEC;
 			return (tok_type=GYS_DELIMETER);
 		}
 		else if(ch=='-' && (file->peek()=='>') ) // ->
 		{
 			file->get(ch);
 			token="->";
+			tok_code=GYS_ARROW;
 			return (tok_type=GYS_DELIMETER);
 		}
 		else if(ch=='|' && (file->peek()=='|') ) // ||
 		{
 			file->get(ch);
 			token="||";
+			tok_code=GYS_OR;
 			return (tok_type=GYS_DELIMETER);
 		}
 		else if(ch=='&' && (file->peek()=='&') ) // &&
 		{
 			file->get(ch);
 			token="&&";
+			tok_code=GYS_AND;
 			return (tok_type=GYS_DELIMETER);
 		}
 		else if(ch=='<' && (file->peek()=='<') ) // <<
 		{
 			file->get(ch);
 			token="<<";
+			tok_code=GYS_SHL;
 
 			if(file->peek()=='=') // <<=
 			{
 				file->get(ch);
 				token="<<=";
+				tok_code=GYS_SHL_ASSIGN;
 			}
 
 			return (tok_type=GYS_DELIMETER);
@@ -661,11 +952,13 @@ GYS_tok_type GYS::get_token()
 		{
 			file->get(ch);
 			token=">>";
+			tok_code=GYS_SHR;
 
 			if(file->peek()=='=') // >>=
 			{
 				file->get(ch);
 				token=">>=";
+				tok_code=GYS_SHR_ASSIGN;
 			}
 
 			return (tok_type=GYS_DELIMETER);
@@ -673,6 +966,7 @@ GYS_tok_type GYS::get_token()
 		else									//, ; : ( ) { } [ ] < > + - * / % ! ^ # ~ .
 		{
 			token=ch;
+			tok_code=(GYS_delim)(strchr(gys_delim_chars, ch)-gys_delim_chars+1);
 			return (tok_type=GYS_DELIMETER);
 		}
 	}
@@ -805,13 +1099,18 @@ GYS_tok_type GYS::get_token()
 	}
 	else if(isalpha(ch) || ch=='_') // name?
 	{
+		unsigned long hash=gys_hash_seed;
+
 		while(isalnum(ch) || ch=='_')
 		{
 			str+=ch;
+			hash=gys_hash_char(hash, ch); // for lookups (see gys_str_hash())
 			if(!file->get(ch))
 				break;
 		}
 
+		tok_hash=hash;
+
 		token=str;
 		tok_val=0; 
 
@@ -863,7 +1162,7 @@ GYS_tok_type GYS::get_token()
 
 			if(ch=='\n' || ch=='\r') line_num++;  // line number
 
-			return get_token();
+			return lex_token();
 		}
 		else if(ch=='*') // -> ......... /*COMMENT*/ .............
 		{
@@ -891,16 +1190,20 @@ GYS_tok_type GYS::get_token()
 	
 				if(ch=='/') is_checking=false;
 			}
-			return get_token();
+			return lex_token();
 		}
 		else // / /=
 		{
 			tok_val=0;
 
 			token='/';
+			tok_code=GYS_DIV;
 
 			if(ch=='=')
+			{
 				token+=ch; // /=
+				tok_code=GYS_DIV_ASSIGN;
+			}
 			else
 				file->putback(ch); // /
 
@@ -912,11 +1215,17 @@ GYS_tok_type GYS::get_token()
 		token="";
 		tok_val=0;
 		error("Unexpected character: ", string()+ch);	
+
+		return lex_token(); // skip it
 	}
 }
 
 bool GYS::exam(string tok)
 {
+	GYS_delim code=gys_delim_code(tok);
+	if(code!=GYS_NO_DELIM) // compare codes
+		return exam(code);
+
 	get_token();
 	string cmp_to=token;
 
@@ -941,6 +1250,26 @@ bool GYS::exam(string tok)
 	return true;
 }
 
+bool GYS::exam(GYS_delim code)
+{
+	get_token();
+
+	if(tok_type==GYS_DELIMETER && tok_code==code)
+		return true;
+
+	string cmp_to=token;
+
+	if(tok_type==GYS_STRING)
+		cmp_to="\""+cmp_to+"\"";
+	else if(tok_type==GYS_CHAR)
+		cmp_to="\'"+cmp_to+"\'";
+	else if(tok_type==GYS_EOF) 
+		cmp_to="*EOF*"; // for readability
+
+	error("Expected '"+string(gys_delim_texts[code])+"' before '"+cmp_to+"'");
+	return false;
+}
+
 bool GYS::exam(GYS_tok_type type)
 {
 	if(get_token()!=type)
@@ -968,16 +1297,109 @@ bool GYS::exam(GYS_tok_type type)
 	return true;
 }
 
+// current token is the odd end-delimeter after the token
+void GYS::add_odd_end(long pos, GYS_delim end)
+{
+	vector<GYS_token_buf::odd_end>& odd_ends=tok_buf->odd_ends;
+
+	if(pos>=(long)odd_ends.size())
+	{
+		GYS_token_buf::odd_end none={GYS_NO_DELIM, 0};
+		odd_ends.resize(tok_buf->toks.size(), none);
+	}
+
+	odd_ends[pos].end=end;
+	odd_ends[pos].pos=tok_cur;
+}
+
+bool GYS::move_to_odd(GYS_delim end, GYS_delim end_pair)
+{
+	if(!tok_buf) // stream mode - read everything
+	{
+		int more=1;
+
+		do
+		{
+			get_token();		
+
+			if(tok_code==end_pair) 
+				more++; // we'll miss one end-delimeter
+			else if(tok_code==end)
+				more--;
+		}	
+		while(tok_type!=GYS_EOF && more);
+
+		return tok_type!=GYS_EOF;
+	}
+
+	vector<GYS_token_buf::odd_end>& odd_ends=tok_buf->odd_ends;
+
+	// the code after the current token was skipped before
+	long start= tok_pos==tok_cur+1 ? tok_cur : -1;
+
+	if(start>=0 && start<(long)odd_ends.size() && odd_ends[start].pos && odd_ends[start].end==end)
+	{
+		set_pos(odd_ends[start].pos);
+		get_token();
+		return true;
+	}
+
+	vector<long> opened; // pairs of the skipped code
+
+	for(;;)
+	{
+		get_token();
+
+		if(tok_type==GYS_EOF)
+			return false;
+
+		if(tok_code==end_pair)
+		{
+			if(tok_cur<(long)odd_ends.size() && odd_ends[tok_cur].pos && odd_ends[tok_cur].end==end)
+				set_pos(odd_ends[tok_cur].pos+1); // skip it at once
+			else
+				opened.push_back(tok_cur);
+		}
+		else if(tok_code==end)
+		{
+			if(opened.empty())
+				break;
+
+			add_odd_end(opened.back(), end);
+			opened.pop_back();
+		}
+	}
+
+	if(start>=0)
+		add_odd_end(start, end);
+
+	return true;
+}
+
 void GYS::putback_tok()
 {
 	if(tok_type==GYS_EOF)
 			return;
 
+	if(tok_buf) // just move back
+	{
+		tok_pos=tok_cur;
+		is_putbacked=true;
+		return;
+	}
+
 	is_putbacked=true;
 }
 
 void GYS::set_pos(long new_pos)
 {
+	if(tok_buf)
+	{
+		tok_pos=new_pos;
+		is_putbacked=false;
+		return;
+	}
+
 	file->clear();
 	file->seekg(new_pos);
 	is_putbacked=false;
@@ -993,60 +1415,311 @@ void GYS::set_super_script(GYS* s)
 	super_script=s;
 }
 
-void GYS::copy_params_to_sub(GYS* s)
+void GYS::copy_params_to_sub(GYS* s, bool thread)
 {
-	s->func_map=func_map;
-	s->type_func_map=type_func_map;
-	s->binary_op_map=binary_op_map;
-	s->pre_unary_op_map=pre_unary_op_map;
-	s->post_unary_op_map=post_unary_op_map;
-	s->converter_map=converter_map;
+	if(!thread)
+		s->lang=lang; // shared until one of the scripts changes it
+	else
+		s->lang=new GYS_language(*lang);
+
+	s->other_thread=other_thread || thread;
 
 	s->warning_func=warning_func;
 	s->error_func=error_func;
 	s->fatal_error_func=fatal_error_func;
 
+	if(flags.test(GYS_PRETOKENIZE))
+		s->enable(GYS_PRETOKENIZE);
+
+	if(flags.test(GYS_COMPILE))
+		s->enable(GYS_COMPILE);
+
+	if(flags.test(GYS_DUMP_BYTECODE))
+		s->enable(GYS_DUMP_BYTECODE);
+
+	if(!flags.test(GYS_OPT_FOLD))
+		s->disable(GYS_OPT_FOLD);
+
+	if(!flags.test(GYS_OPT_BRANCH))
+		s->disable(GYS_OPT_BRANCH);
+
+	if(!flags.test(GYS_OPT_HOIST))
+		s->disable(GYS_OPT_HOIST);
+
+	if(!flags.test(GYS_OPT_INLINE))
+		s->disable(GYS_OPT_INLINE);
+
+	if(!flags.test(GYS_OPT_TAIL_CALL))
+		s->disable(GYS_OPT_TAIL_CALL);
+
 	s->set_super_script(this);
 }
 
 void GYS::copy_vars_to_script(GYS* s)
 {
 	(*s).var_map.insert(var_map.begin(), var_map.end());
+	(*s).var_gen.next();
 }
 
-GYS_ret_val GYS::get_val(string type_name) 
+GYS* GYS::begin_call(const string& name_str, const string& return_type, GYS_source* code)
 {
-	return exec_converter(get_expr_1(type_name), type_name);
-}
+	if(call_frame.busy) // the sub-script is running
+		return 0;
 
-GYS_ret_val GYS::get_var_val(string name) // local or global
-{
-	GYS_var_map::iterator var_iter; 
-	var_iter = var_map.find(name); 
-	if(var_iter!=var_map.end()) // local
+	GYS* s=call_frame.script;
+
+	if(call_frame.bound && call_frame.code==code && flags.test(GYS_OPT_INLINE) && is_inline_code(code))
 	{
-		return (*var_iter).second.first; // value
+		// the same small function: the sub-script keeps its variables and is only rewound
+		if(s->name!=name_str)
+			s->name=name_str;
+		if(s->ret_type!=return_type)
+			s->ret_type=return_type;
+
+		s->lang=lang;
+		s->line_num=1;
+		s->error_num=0;
+		s->warning_num=0;
+		s->tok_pos=0;
+		s->tok_cur=0;
+		s->is_putbacked=false;
+		s->was_finished=false;
+
+		call_frame.busy=true;
+		return s;
 	}
-	else // global
+
+	bool pretokenize=flags.test(GYS_PRETOKENIZE) && !other_thread; // the sub-script of other thread lexes its own tokens
+	istream* in;
+
+	if(pretokenize) // the shared token array is lexed from the shared input
+		in=&code->in;
+	else
 	{
-		GYS_var_map::iterator global_var_iter; 
+		call_frame.in.clear();
+		call_frame.in.str(code->text);
+		in=&call_frame.in;
+	}
 
-		global_var_iter = global_var_map.find(name); 
-	
-		if(global_var_iter!=global_var_map.end())
-			return (*global_var_iter).second.first; // value
-		else
-			error("Unknown variable: ", name); // error
+	if(!s)
+		s=call_frame.script=new GYS(name_str, return_type, in);
+	else // reuse
+	{
+		s->lang=0; // it's shared below, init() mustn't copy its converters
+		s->name=name_str;
+		s->set_input(in);
+		s->ret_type=return_type;
 	}
 
-	return GYS_ret_val();
+	if(pretokenize)
+	{
+		if(!code->tok_buf)
+			code->tok_buf=new GYS_token_buf;
+
+		s->tok_buf=code->tok_buf; // enable() won't make new one
+	}
+
+	copy_params_to_sub(s);
+	call_frame.code=code;
+	call_frame.bound=false;
+	call_frame.busy=true;
+
+	return s;
 }
 
-GYS_ret_val GYS::get_local_var_val(string name) // only local
-{	
-	GYS_var_map::iterator var_iter; 
-	var_iter = var_map.find(name); 
-	if(var_iter!=var_map.end())
+void GYS::end_call()
+{
+	GYS* s=call_frame.script;
+
+	// values of the finished call aren't kept
+	s->ret_val=GYS_ret_val();
+	call_frame.busy=false;
+
+	call_frame.bound=flags.test(GYS_OPT_INLINE) && flags.test(GYS_COMPILE) && !other_thread && is_inline_code(call_frame.code); // other thread doesn't read the shared code
+
+	if(call_frame.bound) // the arguments of the next call will be put into the same variables
+	{
+		for(GYS_var_map::iterator var_iter=s->var_map.begin(); var_iter!=s->var_map.end(); ++var_iter)
+			(*var_iter).second.first.clean();
+	}
+	else
+	{
+		s->var_map.clear();
+		s->var_gen.next();
+	}
+}
+
+void GYS::add_arg_var(const string& vname, const GYS_ret_val& val)
+{
+	bool is_const=(vname[0]=='@');
+	string name=is_const ? vname.substr(1) : vname;
+
+	GYS_var_map::iterator var_iter=var_map.find(name);
+
+	if(var_iter!=var_map.end()) // variable of the bound sub-script (see end_call()), it's still resolved
+	{
+		(*var_iter).second.first.clean(); // not lvalue
+		(*var_iter).second.first=val;
+		(*var_iter).second.second=is_const;
+	}
+	else
+	{
+		var_map[name]=make_pair(val, is_const);
+		var_gen.next();
+	}
+}
+
+void GYS::allow_tail_calls()
+{
+	tail_calls=true;
+	tail_pending=false;
+}
+
+bool GYS::is_tail_call()
+{
+	if(!tail_calls || is_putbacked || !tok_buf || !flags.test(GYS_COMPILE) || !flags.test(GYS_OPT_TAIL_CALL))
+		return false;
+
+	return is_tail_call_at(tok_pos);
+}
+
+void GYS::set_tail_call(const GYS_ret_val& func, const vector<GYS_ret_val>& args)
+{
+	tail_func=func;
+	tail_args=args;
+	tail_pending=true;
+
+	finish_script();
+}
+
+bool GYS::get_tail_call(GYS_ret_val& func, vector<GYS_ret_val>& args)
+{
+	if(!tail_pending)
+		return false;
+
+	tail_pending=false;
+
+	func.clean(); // not lvalue
+	func=tail_func;
+	tail_func.clean();
+
+	args.swap(tail_args);
+	tail_args.clear();
+
+	return true;
+}
+
+bool GYS::lex_ahead(long p)
+{
+	GYS_token_buf& buf=*tok_buf;
+
+	if(p<(long)buf.toks.size())
+		return true;
+
+	if(buf.complete)
+		return false;
+
+	// the lexer appends the tokens, the current one is restored
+	string saved_token=token;
+	GYS_tok_type saved_type=tok_type;
+	GYS_delim saved_code=tok_code;
+	int saved_id=tok_id;
+	unsigned long saved_hash=tok_hash;
+	double saved_val=tok_val;
+	bool saved_putbacked=is_putbacked;
+	long saved_line=line_num, saved_pos=tok_pos, saved_cur=tok_cur, saved_offset=tok_offset;
+
+	is_putbacked=false;
+	while(p>=(long)buf.toks.size() && !buf.complete)
+	{
+		tok_pos=(long)buf.toks.size();
+		get_token();
+	}
+
+	token=saved_token;
+	tok_type=saved_type;
+	tok_code=saved_code;
+	tok_id=saved_id;
+	tok_hash=saved_hash;
+	tok_val=saved_val;
+	is_putbacked=saved_putbacked;
+	line_num=saved_line;
+	tok_pos=saved_pos;
+	tok_cur=saved_cur;
+	tok_offset=saved_offset;
+
+	return p<(long)buf.toks.size();
+}
+
+bool GYS::is_tail_call_at(long p)
+{
+	if(!lex_ahead(p+1) || tok_buf->toks[p].type!=GYS_NAME || tok_buf->toks[p+1].code!=GYS_LPAREN)
+		return false;
+
+	// balanced arguments
+	int more=1;
+	for(p+=2; more; p++)
+	{
+		if(!lex_ahead(p))
+			return false;
+
+		const GYS_token& t=tok_buf->toks[p];
+
+		if(t.type==GYS_EOF)
+			return false;
+		else if(t.code==GYS_LPAREN)
+			more++;
+		else if(t.code==GYS_RPAREN)
+			more--;
+	}
+
+	// nothing is applied to the result (the next statement can follow)
+	if(!lex_ahead(p))
+		return false;
+
+	const GYS_token& t=tok_buf->toks[p];
+
+	return t.type==GYS_EOF || t.type==GYS_NAME || t.type==GYS_CONST || t.code==GYS_SEMICOLON || t.code==GYS_RBRACE;
+}
+
+GYS_ret_val GYS::get_val(string type_name) 
+{
+	return exec_converter(get_expr_1(type_name), type_name);
+}
+
+GYS_ret_val GYS::get_any_val(string raw_type_name)
+{
+	return get_expr_1(raw_type_name);
+}
+
+GYS_ret_val GYS::get_var_val(string name) // local or global
+{
+	GYS_var_map::iterator var_iter; 
+	var_iter = var_map.find(name); 
+	if(var_iter!=var_map.end()) // local
+	{
+		return (*var_iter).second.first; // value
+	}
+	else // global
+	{
+		GYS_var_map::iterator global_var_iter; 
+
+		global_var_iter = global_var_map.find(name); 
+	
+		if(global_var_iter!=global_var_map.end())
+			return (*global_var_iter).second.first; // value
+		else
+			error("Unknown variable: ", name); // error
+	}
+
+	return GYS_ret_val();
+}
+
+GYS_ret_val GYS::get_local_var_val(string name) // only local
+{	
+	GYS_var_map::iterator var_iter; 
+	var_iter = var_map.find(name); 
+	if(var_iter!=var_map.end())
 		return (*var_iter).second.first; 
 	else 
 		error("Unknown local variable: ", name);
@@ -1077,6 +1750,16 @@ GYS_tok_type GYS::get_tok_type() const
 	return tok_type;
 }
 
+GYS_delim GYS::get_tok_code() const
+{
+	return tok_code;
+}
+
+int GYS::get_tok_id() const
+{
+	return tok_buf ? tok_id : -1;
+}
+
 double GYS::get_tok_val() const
 {
 	return tok_val;
@@ -1105,6 +1788,9 @@ long GYS::get_warning_num() const
 
 long GYS::get_pos()
 {
+	if(tok_buf)
+		return tok_pos;
+
 	return file->tellg();
 }
 
@@ -1120,61 +1806,44 @@ GYS* GYS::get_super_script()const
 
 bool GYS::is_binary_op(string op) const
 {
-	if(op=="+"
-	|| op=="-"
-	|| op=="*"
-	|| op=="/"
-	|| op=="%"
-	|| op=="="
-	|| op=="+="
-	|| op=="-="
-	|| op=="*="
-	|| op=="/="
-	|| op=="%="
-	|| op=="=="
-	|| op=="!="
-	|| op=="<"
-	|| op==">"
-	|| op=="<="
-	|| op==">="
-	|| op=="&&"
-	|| op=="||"
-	|| op=="["
-	|| op==":="
-	|| op=="==="
-	|| op=="!=="
-	|| op=="<<"
-	|| op==">>"
-	|| op=="<<="
-	|| op==">>="
-	)
-		return true;
-	else
-		return false;
+	return is_binary_op(gys_delim_code(op));
 }
 
 bool GYS::is_pre_unary_op(string op) const
 {
-	if(op=="+"
-	|| op=="-"
-	|| op=="!"
-	|| op=="++"
-	|| op=="--")
+	return is_pre_unary_op(gys_delim_code(op));
+}
+
+bool GYS::is_post_unary_op(string op) const
+{
+	return is_post_unary_op(gys_delim_code(op));
+}
+
+bool GYS::is_binary_op(GYS_delim code) const
+{
+	return gys_binary_prec[code]>=0;
+}
+
+bool GYS::is_pre_unary_op(GYS_delim code) const
+{
+	switch(code)
+	{
+	case GYS_PLUS: case GYS_MINUS: case GYS_NOT: case GYS_INC: case GYS_DEC:
 		return true;
-	else
+	default:
 		return false;
+	}
 }
 
-bool GYS::is_post_unary_op(string op) const
+bool GYS::is_post_unary_op(GYS_delim code) const
 {
-	if(op=="++"
-	|| op=="--"
-	|| op=="("
-	|| op=="."
-	|| op=="->")	
+	switch(code)
+	{
+	case GYS_INC: case GYS_DEC: case GYS_LPAREN: case GYS_DOT: case GYS_ARROW:
 		return true;
-	else
+	default:
 		return false;
+	}
 }
 
 bool GYS::is_local_var(string var_name)
@@ -1249,9 +1918,9 @@ bool GYS::is_typename(string name)
 {
 	GYS_type_func_map::iterator type_func_iter;
 
-	type_func_iter = type_func_map.find(name); 
+	type_func_iter = lang->type_func_map.find(name); 
 	
-	if(type_func_iter==type_func_map.end())
+	if(type_func_iter==lang->type_func_map.end())
 		return false; // not found
 	
 	return true;
@@ -1261,9 +1930,9 @@ bool GYS::is_func(string name)
 {
 	GYS_func_map::iterator func_iter;
 
-	func_iter = func_map.find(name); 
+	func_iter = lang->func_map.find(name); 
 
-	if(func_iter==func_map.end())
+	if(func_iter==lang->func_map.end())
 		return false; // not found
 	
 	return true;
@@ -1273,8 +1942,8 @@ GYS_ret_val GYS::exec_func()
 {
 	GYS_func_map::iterator func_iter;
 
-	func_iter = func_map.find(token); 
-	if(func_iter!=func_map.end())
+	func_iter = lang->func_map.find(token, tok_hash); 
+	if(func_iter!=lang->func_map.end())
 		return (*func_iter).second(this);
 	else
 	{
@@ -1285,57 +1954,67 @@ GYS_ret_val GYS::exec_func()
 
 GYS_ret_val GYS::exec_converter(GYS_ret_val v, string into_type)
 {
-	if(v.get_type_name()==into_type) // nothing to convert
+	return exec_converter(v, gys_type_id(into_type));
+}
+
+GYS_ret_val GYS::exec_converter(GYS_ret_val v, GYS_type_id into_type)
+{
+	GYS_type_id from_type=v.get_type_id();
+
+	if(from_type==into_type) // nothing to convert
 		return v;
 
-	GYS_converter_map::iterator converter_iter;
+	GYS_CONVERTER_PTR pf=lang->converter_table.get(from_type, into_type);
 
-	converter_iter = converter_map.find(GYS_converter(v.get_type_name(), into_type)); 
-	if(converter_iter!=converter_map.end())
-		return (*converter_iter).second(this, v); // call converter
+	if(pf)
+		return pf(this, v); // call converter
 	else // error
 	{
-		error("Undefined GYS-conversion: from '"+v.get_type_name()+"' into ", into_type);
+		error("Undefined GYS-conversion: from '"+gys_type_name(from_type)+"' into ", gys_type_name(into_type));
 		return GYS_ret_val();
 	}	
 }
 
-GYS_ret_val GYS::exec_binary_op(GYS_ret_val lval, int cur_prec)
+GYS_ret_val GYS::exec_binary_op(GYS_ret_val lval, int cur_prec, GYS_expr_op* rec)
 {	
-	string opname=token;
-
 	// find func for this operator
-	GYS_binary_op_map::iterator b_op_iter = binary_op_map.find( GYS_binary_op(opname, lval.get_type_name()) ); 
+	GYS_binary_op op=lang->binary_op_table.get(get_tok_code(), lval.get_type_id());
 
-	if(b_op_iter!=binary_op_map.end())
+	if(op.func)
 	{
+		const string& r_type=gys_type_name(op.r_type);
+
+		if(rec)
+			rec->r_type=r_type;
+
 		// get right operand
-		GYS_ret_val rval=get_val( /*type-->*/ (*b_op_iter).second.first, cur_prec);
+		GYS_ret_val rval=get_val( /*type-->*/ r_type, cur_prec, rec ? &rec->rval : 0);
 
-		return (*b_op_iter).second.second(this, lval, rval);// processing operator
+		return op.func(this, lval, rval);// processing operator
 	}
 	else // error
 	{
-		error("Binary operator is not defined: ", lval.get_type_name()+opname+"..."); // error - not found
+		error("Binary operator is not defined: ", lval.get_type_name()+token+"..."); // error - not found
 		return GYS_ret_val();
 	}
 }
 
-GYS_ret_val GYS::exec_pre_unary_op(string ret_type)
+GYS_ret_val GYS::exec_pre_unary_op(string ret_type, GYS_expr_node** rec)
 {
 	string opname=token;
-	GYS_pre_unary_op_map::iterator pre_unary_iter;
 
 	// find func for this operator
-	pre_unary_iter = pre_unary_op_map.find( GYS_pre_unary_op(opname, ret_type) ); 
+	GYS_type_id ret_type_id=gys_type_id(ret_type);
+
+	GYS_PRE_UNARY_OP_FUNC_PTR pf=lang->pre_unary_op_table.get(get_tok_code(), ret_type_id);
 
-	if(pre_unary_iter!=pre_unary_op_map.end())
+	if(pf)
 	{
 		// rtype=ret_type!
-		GYS_ret_val rval=get_val(ret_type);     // get right operand
+		GYS_ret_val rval=get_val(ret_type, 0, rec); // get right operand
 		
-		GYS_ret_val result=(*pre_unary_iter).second(this, rval); // processing operator
-		if(result.get_type_name()==ret_type) // ok
+		GYS_ret_val result=pf(this, rval); // processing operator
+		if(result.get_type_id()==ret_type_id) // ok
 			return result;
 		else                                 // error
 		{
@@ -1352,250 +2031,108 @@ GYS_ret_val GYS::exec_pre_unary_op(string ret_type)
 
 GYS_ret_val GYS::exec_post_unary_op(GYS_ret_val lval)
 {
-	string opname=token;
-	GYS_post_unary_op_map::iterator post_unar_iter;
-
 	// find func for this operator
-	post_unar_iter = post_unary_op_map.find( GYS_post_unary_op(opname, lval.get_type_name()) ); 
+	GYS_POST_UNARY_OP_FUNC_PTR pf=lang->post_unary_op_table.get(get_tok_code(), lval.get_type_id());
 
-	if(post_unar_iter!=post_unary_op_map.end())
-	{
-		GYS_ret_val result=(*post_unar_iter).second(this, lval); // processing operator
-		return result;		
-	}
+	if(pf)
+		return pf(this, lval); // processing operator
 	else // error
 	{
-		error("Postfix unary operator is not defined: ", lval.get_type_name()+opname); // not found
+		error("Postfix unary operator is not defined: ", lval.get_type_name()+token); // not found
 		return GYS_ret_val();
 	}
 }
 
-GYS_ret_val GYS::get_val(string type, int cur_prec) 
+GYS_ret_val GYS::get_val(string type, int cur_prec, GYS_expr_node** rec)
 {
 	GYS_ret_val result;
-	switch(cur_prec)
-	{
-	case 0:
-		result=get_expr_1(type);
-		break;
-	case 1:
-		result=get_expr_2(type);
-		break;
-	case 2:
-		result=get_expr_3(type);
-		break;
-	case 3:
-		result=get_expr_4(type);
-		break;
-	case 4:
-		result=get_expr_5(type);
-		break;
-	case 5:
-		result=get_expr_6(type);
-		break;
-	case 6:
-		result=get_expr_7(type);
-		break;
-	case 7:
-		result=get_expr_8(type);
-		break;
-	default:
-		result=get_prim(type);
-	}
+	result=get_expr(cur_prec<8 ? cur_prec+1 : 9, type, rec);
 
 	return exec_converter(result, type);
 }
-// := = += -= *= /= %= <<= >>=
+
+// the whole expression
 GYS_ret_val GYS::get_expr_1(string type)
 {
-	GYS_ret_val left=get_expr_2(type);
-	GYS_ret_val result=left;
-	
-	for(;;)
-	{
-		get_token();
-		
-		if( tok_type==GYS_DELIMETER && (
-			token==":=" ||
-			token=="="  ||
-			token=="+=" ||
-			token=="-=" ||
-			token=="*=" ||
-			token=="/=" ||
-			token=="%=" ||
-			token=="<<=" ||
-			token==">>="
-			) ) 
-		{
-			result.clean(); // not lvalue
-			result=exec_binary_op(left, 1);
+	if(!flags.test(GYS_COMPILE) || !tok_buf) // just interpret
+		return get_expr(1, type);
 
-			left.clean(); // not lvalue
-			left=result;
-		}
-		else
-		{
-			putback_tok();
+	RefCntPointer<GYS_token_buf> buf=tok_buf; // keep trees alive
+	long pos=tok_pos;
 
-			return result;
-		}
-	}
-}
-
-// ||
-GYS_ret_val GYS::get_expr_2(string type)
-{
-	GYS_ret_val left=get_expr_3(type);
-	GYS_ret_val result=left;	
-		
-	for(;;)
+	if(GYS_token_buf::expr* e=buf->find_expr(pos, type)) // compiled
 	{
-		get_token();
-		
-		if(tok_type==GYS_DELIMETER && token=="||") 
-		{
-			result.clean(); // not lvalue
-			result=exec_binary_op(left, 2);
-
-			left.clean(); // not lvalue
-			left=result;
-		}
-		else
+		// the code which was left can be compiled better when new trees appear
+		if( !e->code || (e->code->stale && e->code->expr_count!=buf->expr_count && e->versions<gys_max_code_versions) )
 		{
-			putback_tok();
-			
-			return result;
+			e->code=compile_expr(e->node, type);
+			e->versions++;
 		}
+
+		RefCntPointer<GYS_code> code=e->code; // callbacks can compile other expressions
+		return exec_code(code);
 	}
-}
 
-// &&
-GYS_ret_val GYS::get_expr_3(string type)
-{
-	GYS_ret_val left=get_expr_4(type);
-	GYS_ret_val result=left;
-		
-	for(;;)
-	{
-		get_token();
-		
-		if(tok_type==GYS_DELIMETER && token=="&&") 
-		{
-			result.clean(); // not lvalue
-			result=exec_binary_op(left, 3);
+	// interpret and record the tree
+	long old_error_num=error_num;
+	GYS_expr_node* node=0;
 
-			left.clean(); // not lvalue
-			left=result;
-		}
-		else
-		{
-			putback_tok();
-			
-			return result;
-		}
-	}
-}
+	GYS_ret_val result=get_expr(1, type, &node);
 
-// === == != !==
-GYS_ret_val GYS::get_expr_4(string type)
-{
-	GYS_ret_val left=get_expr_5(type);
-	GYS_ret_val result=left;
-		
-	for(;;)
-	{
-		get_token();
-		
-		if(tok_type==GYS_DELIMETER && (token=="===" || token=="==" || token=="!=" || token=="!==") ) 
-		{
-			result.clean(); // not lvalue
-			result=exec_binary_op(left, 4);
+	if(node && error_num==old_error_num && !buf->find_expr(pos, type))
+		buf->add_expr(pos, type, node);
+	else // something went wrong - try to compile it next time
+		delete node;
 
-			left.clean(); // not lvalue
-			left=result;
-		}
-		else
-		{
-			putback_tok();
-			
-			return result;
-		}
-	}
+	return result;
 }
 
-// < > <= >=
-GYS_ret_val GYS::get_expr_5(string type)
+// levels:
+// 1 - := = += -= *= /= %= <<= >>=
+// 2 - ||
+// 3 - &&
+// 4 - === == != !==
+// 5 - < > <= >=
+// 6 - << >>
+// 7 - + -
+// 8 - * / %
+// 9 - primary
+GYS_ret_val GYS::get_expr(int level, string type, GYS_expr_node** rec)
 {
-	GYS_ret_val left=get_expr_6(type);
-	GYS_ret_val result=left;
-		
-	for(;;)
-	{
-		get_token();
-		
-		if(tok_type==GYS_DELIMETER && (
-			token=="<" ||
-			token==">" ||
-			token=="<=" ||
-			token==">="
-			) ) 
-		{
-			result.clean(); // not lvalue
-			result=exec_binary_op(left, 5);
+	if(level>8)
+		return get_prim(type, rec);
 
-			left.clean(); // not lvalue
-			left=result;
-		}
-		else
-		{
-			putback_tok();
-			
-			return result;
-		}
-	}
+	GYS_ret_val left=get_expr(level+1, type, rec);
+
+	return get_expr_loop(level, left, rec);
 }
 
-// << >>
-GYS_ret_val GYS::get_expr_6(string type)
+// rec: in - tree of the first operand, out - tree of the whole expression
+GYS_ret_val GYS::get_expr_loop(int level, GYS_ret_val left, GYS_expr_node** rec)
 {
-	GYS_ret_val left=get_expr_7(type);
 	GYS_ret_val result=left;
+	GYS_expr_node* node=0;
 
 	for(;;)
 	{
 		get_token();
-				
-		if(tok_type==GYS_DELIMETER && (token=="<<" || token==">>") ) 
-		{
-			result.clean(); // not lvalue
-			result=exec_binary_op(left, 6);
 
-			left.clean(); // not lvalue
-			left=result;
-		}
-		else
+		if(gys_binary_prec[tok_code]==level)
 		{
-			putback_tok();
-			
-			return result;
-		}
-	}
-}
+			if(rec && *rec)
+			{
+				if(!node) // first operator of this level
+				{
+					node=new GYS_expr_node(GYS_EXPR_OPS, level, (*rec)->pos);
+					node->sub=*rec;
+					*rec=node;
+				}
 
-// + -
-GYS_ret_val GYS::get_expr_7(string type)
-{
-	GYS_ret_val left=get_expr_8(type);
-	GYS_ret_val result=left;
+				node->ops.push_back(GYS_expr_op(tok_code, tok_cur));
+			}
 
-	for(;;)
-	{
-		get_token();
-				
-		if(tok_type==GYS_DELIMETER && (token=="+" || token=="-") ) 
-		{
 			result.clean(); // not lvalue
-			result=exec_binary_op(left, 7);
+			result=exec_binary_op(left, level, node ? &node->ops.back() : 0);
 
 			left.clean(); // not lvalue
 			left=result;
@@ -1603,38 +2140,10 @@ GYS_ret_val GYS::get_expr_7(string type)
 		else
 		{
 			putback_tok();
-			
-			return result;
-		}
-	}
-}
 
-// * / %
-GYS_ret_val GYS::get_expr_8(string type)
-{
-	GYS_ret_val left=get_prim(type);
-	GYS_ret_val result=left;
-		
-	for(;;)
-	{
-		get_token();
-		
-		if(tok_type==GYS_DELIMETER && (
-			token=="*" ||
-			token=="/" ||
-			token=="%"
-			) ) 
-		{
-			result.clean(); // not lvalue
-			result=exec_binary_op(left, 8);
+			if(node)
+				node->end=tok_cur;
 
-			left.clean(); // not lvalue
-			left=result;
-		}
-		else
-		{
-			putback_tok();
-			
 			return result;
 		}
 	}
@@ -1644,60 +2153,86 @@ GYS_ret_val GYS::get_expr_8(string type)
 // unary prefix
 // unary postfix
 // binary []
-GYS_ret_val GYS::get_prim(string type)
+GYS_ret_val GYS::get_prim(string type, GYS_expr_node** rec)
 {
 	get_token();
 
     GYS_ret_val left, result;
 
-	if(tok_type==GYS_NAME && is_var(token)) // var var^
-	{	
+	GYS_expr_node* node=0;
+	if(rec)
+		*rec=node=new GYS_expr_node(GYS_EXPR_RAW, 9, tok_cur);
+
+	GYS_var_ref new_ref;
+	GYS_var_ref& var= tok_buf && tok_type==GYS_NAME ? tok_buf->get_var_ref(tok_cur) : new_ref; // kept by token index in token array mode
+
+	if(tok_type==GYS_NAME)
+		find_var(token, tok_hash, var);
+
+	if(var.local || var.global) // var var^
+	{
 		string vname=token;
 		get_token();
 
-		if(flags.test(GYS_GLOBAL_VAR_OP) && tok_type==GYS_DELIMETER && token=="^") // only global var
+		if(node)
 		{
-			if(is_global_const(vname)) // is const
-			{
-				left=get_global_var_val(vname); // not lvalue
-			}
+			node->kind=GYS_EXPR_VAR;
+			node->name=vname;
+		}
+
+		if(flags.test(GYS_GLOBAL_VAR_OP) && tok_code==GYS_CARET) // only global var
+		{
+			if(node)
+				node->kind=GYS_EXPR_GLOBAL_VAR;
+
+			if(!var.global)
+				error("Unknown global variable: ", vname);
+			else if(var.global->second) // is const
+				left=var.global->first; // not lvalue
 			else
-			{
-				if(GYS_ret_val* t=get_global_var(vname))
-					left=t;
-			}
+				left=&var.global->first;
 		}
 		else // var
 		{
 			putback_tok();
 
-			if(is_const(vname)) // is const
-			{
-				left=get_var_val(vname); // not lvalue
-			}
+			if(var.is_const())
+				left=var.cell()->first; // not lvalue
 			else
-			{
-				if(GYS_ret_val* t=get_var(vname))
-					left=t;
-			}
+				left=&var.cell()->first;
 		}
 	}
 	else if(tok_type==GYS_NAME) // func or conversion
 	{
-		left=exec_func();		
+		if(node)
+			node->kind=GYS_EXPR_FUNC;
+
+		left=exec_func();
+
+		if(node)
+			node->head_end=tok_pos;
 	}
-	else if(tok_type==GYS_DELIMETER && is_pre_unary_op( token ) ) // prefix unary
+	else if(is_pre_unary_op(tok_code)) // prefix unary
 	{
-		left=exec_pre_unary_op(type);		
+		if(node)
+		{
+			node->kind=GYS_EXPR_PRE_UNARY;
+			node->code=tok_code;
+		}
+
+		left=exec_pre_unary_op(type, node ? &node->sub : 0);
 	}
-	else if(tok_type==GYS_DELIMETER && token=="(" ) // (expr)
+	else if(tok_code==GYS_LPAREN) // (expr)
 	{
-		GYS_ret_val e=get_expr_1(type);
+		if(node)
+			node->kind=GYS_EXPR_PAREN;
+
+		GYS_ret_val e=get_expr(1, type, node ? &node->sub : 0);
 		get_token();
-		if( !(tok_type==GYS_DELIMETER && token==")") )
+		if(tok_code!=GYS_RPAREN)
 		{
 			error("Expression anal: ')' expected: ", token);
-			return GYS_ret_val(); 
+			return GYS_ret_val();
 		}
 
 		left=e;
@@ -1706,36 +2241,57 @@ GYS_ret_val GYS::get_prim(string type)
 	{
 		putback_tok();
 		left=get_raw_val(type);
+
+		if(node)
+			node->head_end=tok_pos;
 	}
 
-	result=left;
+	return get_prim_loop(left, node);
+}
+
+GYS_ret_val GYS::get_prim_loop(GYS_ret_val left, GYS_expr_node* rec)
+{
+	GYS_ret_val result=left;
 
 	// postfix unary ops and binary []
 	for(;;)
 	{
 		get_token();
 
-		if(tok_type==GYS_DELIMETER && is_post_unary_op(token)) // postfix unary ops
+		if(is_post_unary_op(tok_code)) // postfix unary ops
 		{
+			if(rec)
+				rec->ops.push_back(GYS_expr_op(tok_code, tok_cur));
+
 			result.clean(); // not lvalue
 			result=exec_post_unary_op(left);
 
 			left.clean(); // not lvalue
 			left=result;
+
+			if(rec)
+				rec->ops.back().end=tok_pos;
 		}
-		else if(tok_type==GYS_DELIMETER && token=="[") // binary []
+		else if(tok_code==GYS_LBRACKET) // binary []
 		{
+			if(rec)
+				rec->ops.push_back(GYS_expr_op(tok_code, tok_cur));
+
 			result.clean(); // not lvalue
-			result=exec_binary_op(left, 0);
+			result=exec_binary_op(left, 0, rec ? &rec->ops.back() : 0);
 
 			left.clean(); // not lvalue
 			left=result;
 
-			exam("]");
+			exam(GYS_RBRACKET);
 		}
 		else
 		{
 			putback_tok();
+
+			if(rec)
+				rec->end=tok_cur;
+
 			return result;
 		}
 	}
@@ -1747,9 +2303,9 @@ GYS_ret_val GYS::get_raw_val(string type_name)
 	
 	GYS_type_func_map::iterator type_func_iter;
 
-	type_func_iter = type_func_map.find(type_name); 
+	type_func_iter = lang->type_func_map.find(type_name); 
 	
-	if(type_func_iter!=type_func_map.end())
+	if(type_func_iter!=lang->type_func_map.end())
 	{
 		v=(*type_func_iter).second(this); // call type func
 	}
@@ -1819,25 +2375,178 @@ GYS_ret_val* GYS::get_global_var(string name)
 	}
 }
 
+bool GYS::find_var(const string& name, unsigned long hash, GYS_var_ref& ref)
+{
+	if(ref.local_gen!=var_gen || ref.global_gen!=global_var_gen) // names were changed (or ref is new)
+	{
+		GYS_var_map::iterator var_iter=var_map.find(name, hash);
+		ref.local= var_iter!=var_map.end() ? &(*var_iter).second : 0;
+
+		var_iter=global_var_map.find(name, hash);
+		ref.global= var_iter!=global_var_map.end() ? &(*var_iter).second : 0;
+
+		ref.local_gen=var_gen;
+		ref.global_gen=global_var_gen;
+	}
+
+	return ref.local || ref.global;
+}
+
+//--------------------------delimeters-------------------------------
+GYS_delim gys_delim_code(const string& str)
+{
+	if(str.length()==1) // one-char
+	{
+		const char* p=strchr(gys_delim_chars, str[0]);
+		return (p && *p) ? (GYS_delim)(p-gys_delim_chars+1) : GYS_NO_DELIM;
+	}
+
+	for(int i=GYS_EQUAL; i<GYS_DELIM_NUM; i++)
+		if(str==gys_delim_texts[i])
+			return (GYS_delim)i;
+
+	return GYS_NO_DELIM;
+}
+
+const char* gys_delim_str(GYS_delim code)
+{
+	return gys_delim_texts[code];
+}
+
+//--------------------------token array-------------------------------
+int GYS_token_buf::intern(const string& str, unsigned long hash)
+{
+	pair<GYS_hash_map<int>::iterator, bool> it=text_ids.insert(make_pair(str, (int)texts.size()), hash);
+	if(it.second) // new one
+	{
+		texts.push_back(str);
+		text_hashes.push_back(hash);
+	}
+
+	return it.first->second;
+}
+
+GYS_token_buf::~GYS_token_buf()
+{
+	for(size_t i=0; i<exprs.size(); i++)
+		for(size_t j=0; j<exprs[i].size(); j++)
+			delete exprs[i][j].node;
+}
+
+GYS_token_buf::expr* GYS_token_buf::find_expr(long pos, const string& type)
+{
+	if(pos<0 || pos>=(long)exprs.size())
+		return 0;
+
+	vector<expr>& v=exprs[pos];
+	for(size_t i=0; i<v.size(); i++)
+		if(v[i].type==type)
+			return &v[i];
+
+	return 0;
+}
+
+void GYS_token_buf::add_expr(long pos, const string& type, GYS_expr_node* node)
+{
+	if(pos>=(long)exprs.size())
+		exprs.resize(pos+1);
+
+	expr e;
+	e.type=type;
+	e.node=node;
+	e.versions=0;
+
+	exprs[pos].push_back(e);
+	expr_count++;
+}
+
+GYS_token_buf::func_code& GYS_token_buf::get_func_code(long pos, GYS_FUNC_COMPILER_PTR pf)
+{
+	if(pos>=(long)func_codes.size())
+		func_codes.resize(pos+1);
+
+	vector<func_code>& v=func_codes[pos];
+	for(size_t i=0; i<v.size(); i++)
+		if(v[i].pf==pf)
+			return v[i];
+
+	func_code c;
+	c.pf=pf;
+	c.versions=0;
+	c.fail_count=-1;
+
+	v.push_back(c);
+	return v.back();
+}
+
+GYS_var_ref& GYS_token_buf::get_var_ref(long pos)
+{
+	if(pos>=(long)var_refs.size())
+		var_refs.resize(toks.size()>(size_t)pos ? toks.size() : pos+1);
+
+	return var_refs[pos];
+}
+
+//--------------------------expression trees-------------------------------
+GYS_expr_node::~GYS_expr_node()
+{
+	delete sub;
+
+	for(size_t i=0; i<ops.size(); i++)
+		delete ops[i].rval;
+}
+
 // for map
-bool operator<(const GYS_binary_op l, const GYS_binary_op r)
+//--------------------------GYS type ids-------------------------------
+// typenames by id (the registry is shared by all the scripts)
+static vector<string>& type_names()
+{
+	static vector<string> names(1, gys_void_type); // void is 0
+
+	return names;
+}
+
+static map<string, GYS_type_id>& type_ids()
 {
-	return l.get_comp_name()<r.get_comp_name();
+	static map<string, GYS_type_id> ids;
+
+	if(ids.empty())
+		ids[gys_void_type]=gys_void_type_id;
+
+	return ids;
 }
 
-bool operator<(const GYS_post_unary_op l, const GYS_post_unary_op r)
+GYS_type_id gys_type_id(const string& type_name)
 {
-	return l.get_comp_name()<r.get_comp_name();
+	map<string, GYS_type_id>& ids=type_ids();
+	map<string, GYS_type_id>::iterator it=ids.find(type_name);
+
+	if(it!=ids.end())
+		return (*it).second;
+
+	vector<string>& names=type_names();
+	GYS_type_id id=(GYS_type_id)names.size();
+
+	names.push_back(type_name);
+	ids[type_name]=id;
+
+	return id;
 }
 
-bool operator<(const GYS_pre_unary_op l, const GYS_pre_unary_op r)
+const string& gys_type_name(GYS_type_id id)
 {
-	return l.get_comp_name()<r.get_comp_name();
+	vector<string>& names=type_names();
+
+	if(id<0 || id>=(GYS_type_id)names.size())
+		return names[gys_void_type_id];
+
+	return names[id];
 }
 
-bool operator<(const GYS_converter l, const GYS_converter r)
+//--------------------------call frames-------------------------------
+GYS_call_frame::~GYS_call_frame()
 {
-	return l.get_comp_name()<r.get_comp_name();
+	delete script;
 }
 
 //--------------------------GYS return values-------------------------------
@@ -1848,48 +2557,61 @@ GYS_ret_val::GYS_ret_val()
 
 GYS_ret_val::GYS_ret_val(const GYS_ret_val& v)
 {
+	lvalue=0;
+
 	if(v.is_lvalue())
-		set_lvalue(v.get_lvalue());
-	else if(v.get_type_name()==gys_void_type)
+		set_lvalue(v.lvalue, v.user_val); // keeps the proxy
+	else if(v.type_id==gys_void_type_id)
 		clean();
 	else
-		set_user_val(v.get_ptr_to_user_val());
+	{
+		user_val=v.user_val;
+		small_val=v.small_val;
+		type_id=v.type_id;
+	}
 }
 
 void GYS_ret_val::clean()
 {
 	lvalue=0;
 	user_val=0;
-	type_name=gys_void_type;
+	type_id=gys_void_type_id;
 }
 
 GYS_ret_val& GYS_ret_val::operator=(const GYS_ret_val v)
 {
-	string new_type=v.get_type_name();
+	GYS_type_id new_type=v.get_type_id();
 	
-	if(type_name==gys_lvalue_type) // set lvalue
+	if(type_id==gys_lvalue_type_id) // set lvalue
 	{
 		// void
-		if(new_type==gys_void_type)
-			type_name=gys_void_type;
+		if(new_type==gys_void_type_id)
+			type_id=gys_void_type_id;
 
 		// user type
 		else
-			lvalue->set_user_val(v.get_ptr_to_user_val());
+		{
+			const GYS_ret_val* pv=&v;
+			while(pv->type_id==gys_lvalue_type_id)
+				pv=pv->read_lvalue();
+
+			lvalue->set_val_of(*pv);
+			changed();
+		}
 	}
 	else // set new value
 	{
 		// void
-		if(new_type==gys_void_type)
-			type_name=gys_void_type;	
+		if(new_type==gys_void_type_id)
+			type_id=gys_void_type_id;	
 
 		// lvalue
 		else if(v.is_lvalue())
-			set_lvalue(v.get_lvalue());
+			set_lvalue(v.lvalue, v.user_val);
 	
 		// user type
 		else
-			set_user_val(v.get_ptr_to_user_val());
+			set_val_of(v);
 	}
 
 	return *this;
@@ -1897,17 +2619,20 @@ GYS_ret_val& GYS_ret_val::operator=(const GYS_ret_val v)
 
 string GYS_ret_val::get_type_name() const
 {
-	if(type_name==gys_user_type)
-		return user_val->get_type_name();
-	else if(type_name==gys_lvalue_type)
-		return lvalue->get_type_name();
+	return gys_type_name(get_type_id());
+}
+
+GYS_type_id GYS_ret_val::get_type_id() const
+{
+	if(type_id==gys_lvalue_type_id)
+		return read_lvalue()->get_type_id();
 	else
-		return type_name;
+		return type_id;
 }
 
 bool GYS_ret_val::is_lvalue() const
 {
-	return type_name==gys_lvalue_type ? true : false;
+	return type_id==gys_lvalue_type_id ? true : false;
 }
 
 GYS_ret_val::GYS_ret_val(GYS_ret_val* p)
@@ -1920,14 +2645,36 @@ GYS_ret_val& GYS_ret_val::set_lvalue(GYS_ret_val* p)
 	user_val=0;
 
 	lvalue=p;
-	type_name=gys_lvalue_type;
+	type_id=gys_lvalue_type_id;
 
 	return *this;
 }
 
+GYS_ret_val& GYS_ret_val::set_lvalue(GYS_ret_val* p, GYS_user_val* proxy)
+{
+	set_lvalue(p);
+	user_val=proxy;
+
+	return *this;
+}
+
+void GYS_ret_val::changed()
+{
+	if(user_val)
+		user_val->lvalue_changed();
+}
+
+GYS_ret_val* GYS_ret_val::read_lvalue() const
+{
+	if(user_val)
+		user_val->lvalue_read();
+
+	return lvalue;
+}
+
 GYS_ret_val& GYS_ret_val::operator=(GYS_ret_val* p)
 {
-	if(type_name==gys_lvalue_type)
+	if(type_id==gys_lvalue_type_id)
 		lvalue->set_lvalue(p);
 	else
 		set_lvalue(p);
@@ -1937,7 +2684,7 @@ GYS_ret_val& GYS_ret_val::operator=(GYS_ret_val* p)
 
 GYS_ret_val* GYS_ret_val::get_lvalue() const
 {
-	if(type_name==gys_lvalue_type)
+	if(type_id==gys_lvalue_type_id)
 		return lvalue;
 	else
 		return 0;
@@ -1945,39 +2692,122 @@ GYS_ret_val* GYS_ret_val::get_lvalue() const
 
 void GYS_ret_val::set_user_val(GYS_user_val* user_v)
 {
-	if(type_name==gys_lvalue_type)
-		lvalue->set_user_val(user_v);
+	set_user_val(user_v, user_v->get_type_id());
+}
+
+void GYS_ret_val::set_user_val(GYS_user_val* user_v, GYS_type_id id)
+{
+	if(type_id==gys_lvalue_type_id)
+	{
+		lvalue->set_user_val(user_v, id);
+		changed();
+	}
 	else
 	{
-		type_name=gys_user_type;
+		type_id=id;
 		user_val=user_v;
 	}
 }
 
+void GYS_ret_val::set_val_of(const GYS_ret_val& v)
+{
+	if(type_id==gys_lvalue_type_id)
+	{
+		lvalue->set_val_of(v);
+		changed();
+	}
+	else
+	{
+		type_id=v.type_id;
+		user_val=v.user_val;
+		small_val=v.small_val;
+	}
+}
+
+void GYS_ret_val::set_small_val(bool val, GYS_type_id id)
+{
+	if(type_id==gys_lvalue_type_id)
+	{
+		lvalue->set_small_val(val, id);
+		changed();
+	}
+	else
+	{
+		type_id=id;
+		user_val=0;
+		small_val.b=val;
+	}
+}
+
+void GYS_ret_val::set_small_val(char val, GYS_type_id id)
+{
+	if(type_id==gys_lvalue_type_id)
+	{
+		lvalue->set_small_val(val, id);
+		changed();
+	}
+	else
+	{
+		type_id=id;
+		user_val=0;
+		small_val.c=val;
+	}
+}
+
+void GYS_ret_val::set_small_val(int val, GYS_type_id id)
+{
+	if(type_id==gys_lvalue_type_id)
+	{
+		lvalue->set_small_val(val, id);
+		changed();
+	}
+	else
+	{
+		type_id=id;
+		user_val=0;
+		small_val.i=val;
+	}
+}
+
+void GYS_ret_val::set_small_val(double val, GYS_type_id id)
+{
+	if(type_id==gys_lvalue_type_id)
+	{
+		lvalue->set_small_val(val, id);
+		changed();
+	}
+	else
+	{
+		type_id=id;
+		user_val=0;
+		small_val.d=val;
+	}
+}
+
 void* GYS_ret_val::get_user_val()
 {
-	if(type_name==gys_user_type)
-		return user_val->get_user_val();
-	else if(type_name==gys_lvalue_type)
-		return lvalue->get_user_val();
+	if(type_id>gys_void_type_id)
+		return user_val ? user_val->get_user_val() : &small_val; // small value is inline
+	else if(type_id==gys_lvalue_type_id)
+		return read_lvalue()->get_user_val();
 	else
 		return 0;
 }
 
 GYS_user_val* GYS_ret_val::get_ptr_to_user_val() const
 {
-	if(type_name==gys_user_type)
+	if(type_id>gys_void_type_id)
 		return user_val;
-	else if(type_name==gys_lvalue_type)
-		return lvalue->get_ptr_to_user_val();
+	else if(type_id==gys_lvalue_type_id)
+		return read_lvalue()->get_ptr_to_user_val();
 	else
 		return 0;
 }
 
 GYS_ret_val GYS_ret_val::get_value() const
 {
-	if(type_name==gys_lvalue_type)
-		return lvalue->get_value();
+	if(type_id==gys_lvalue_type_id)
+		return read_lvalue()->get_value();
 	else
 		return *this;
 }
@@ -31,6 +31,8 @@
 #include <string>   
 #include <map>      
 #include <vector>   
+#include <deque>
+#include <sstream>
 #include <bitset>
 
 #include "ref_cnt_ptr.h" // smart pointers
@@ -40,11 +42,10 @@ using namespace std;
 // for user
 class  GYS;
 class  GYS_ret_val;
+class  GYS_compiler;
 
 // for inner using
-class  GYS_binary_op;
-class  GYS_pre_unary_op;
-class  GYS_post_unary_op;
+class  GYS_token_buf;
 
 //:::::::::::::::::::::::::::::::::::::::::GYS return values:::::::::::::::::::::::::::::::::::::::::
 /*!
@@ -58,6 +59,33 @@ static const char* gys_lvalue_type    = "<lvalue>"; //!< Used for lvalue in GYS_
 static const char* gys_user_type      = "<user>"; //!< Used for user_val in GYS_ret_val (inner).
 /*@}*/
 
+//:::::::::::::::::::::::::::::::::::::::::Type ids:::::::::::::::::::::::::::::::::::::::::
+/*!
+  \defgroup type_ids Type ids.
+  Every typename gets its small integer id once (e.g. in GYS::add_gys_type()),
+  values and operators keep these ids, so types are compared without strings.
+*/
+/*@{*/
+typedef int GYS_type_id; //!< Type id.
+
+static const GYS_type_id gys_void_type_id   = 0;  //!< Id of "void" type.
+static const GYS_type_id gys_lvalue_type_id = -1; //!< Used for lvalue in GYS_ret_val (inner).
+
+//! Returns the id of the typename (new typename gets the next id).
+/*!
+  \param type_name typename.
+  \return Type id.
+*/
+GYS_type_id gys_type_id(const string& type_name);
+
+//! Returns the typename of the id.
+/*!
+  \param id type id.
+  \return Typename ("void" if the id is unknown).
+*/
+const string& gys_type_name(GYS_type_id id);
+/*@}*/
+
 
 //! User value abstract class.
 /*!
@@ -83,19 +111,62 @@ public:
 	  \return User value typename.
 	*/
 	virtual string get_type_name() const =0;
+
+	//! Returns type id of user value.
+	/*!
+	  Redefine it to return the id without string operations (the default one looks for get_type_name()).
+
+	  \return User value type id.
+	*/
+	virtual GYS_type_id get_type_id() const {
+		return gys_type_id(get_type_name());
+	}
+
+	//! Is called when the value is changed through lvalue which keeps this user value as its proxy.
+	/*!
+	  Redefine it to write the new value back into user's storage (see GYS_ret_val::set_lvalue()).
+	*/
+	virtual void lvalue_changed() {}
+
+	//! Is called before the value is read through lvalue which keeps this user value as its proxy.
+	/*!
+	  Redefine it to read the value again from user's storage (it may be changed through other lvalues).
+	*/
+	virtual void lvalue_read() {}
+
+	//! Checks if the values kept by this one (e.g. elements of a container) are shared with other values.
+	/*!
+	  Redefine it for the containers of user values: the calls of pure functions are hoisted
+	  only while their arguments aren't shared (see GYS_OPT_HOIST).
+	*/
+	virtual bool shares_values() const { return false; }
 };
 
 //! Return value class.
 /*!
 	Objects of this class are used to store all the values used by the interpreter.
+	Small values (bool, char, int, double) can be stored inside the object itself
+	(see set_small_val()), other ones are stored in GYS_user_val.
 */
 class GYS_ret_val
 {
 private:
 	GYS_ret_val* lvalue; 
-	RefCntPointer<GYS_user_val> user_val;
+	RefCntPointer<GYS_user_val> user_val; // 0 - small value is stored in small_val
+
+	union {
+		bool   b;
+		char   c;
+		int    i;
+		double d;
+	} small_val; // inline data of small value
+
+	GYS_type_id type_id; // value type, gys_void_type_id or gys_lvalue_type_id
 
-	string type_name;
+	void set_user_val(GYS_user_val* user_val, GYS_type_id id); // id is known
+	void set_val_of(const GYS_ret_val& v); // v is "final" value (not lvalue)
+	void changed(); // notifies the proxy of lvalue
+	GYS_ret_val* read_lvalue() const; // lvalue refreshed by its proxy
 
 public:
 	//! Creates value of void type.
@@ -105,7 +176,7 @@ public:
     /*!
 	  \param user_val user data.
     */
-	template<class T> GYS_ret_val(T user_val) {
+	template<class T> GYS_ret_val(T user_val) : lvalue(0), type_id(gys_void_type_id) {
 		store(*this, user_val);
 	}
 
@@ -151,6 +222,12 @@ public:
     */
 	string get_type_name() const;
 
+	//! Gets type id of the current stored data.
+    /*!
+	  \return Current type id.
+    */
+	GYS_type_id get_type_id() const;
+
 	//! Checks if current value is lvalue.
     /*!
 	  \return <b>true</b> - if current value is lvalue, <b>false</b> - instead.
@@ -163,6 +240,17 @@ public:
     */
 	GYS_ret_val& set_lvalue(GYS_ret_val* p);
 
+	//! Sets lvalue with proxy.
+    /*!
+	  Copies of the lvalue keep the proxy, its GYS_user_val::lvalue_changed() is called
+	  when the value is changed through them and GYS_user_val::lvalue_read() - before it's read
+	  (e.g. p points to a copy of data kept outside GYS_ret_val).
+
+	  \param p pointer to source value.
+	  \param proxy user value to be notified of the changes and the reads.
+    */
+	GYS_ret_val& set_lvalue(GYS_ret_val* p, GYS_user_val* proxy);
+
 	//! Gets lvalue.
     /*!
 	  \return "L-value" value or 0 - if there's no lvalue.
@@ -175,6 +263,24 @@ public:
     */
 	void set_user_val(GYS_user_val* user_val);
 
+	//! Sets small value (without GYS_user_val), can be used with lvalue.
+    /*!
+	  Use it in store() for small types, operator T() returns the same data.
+
+	  \param val data.
+	  \param id type id of the value.
+    */
+	void set_small_val(bool val, GYS_type_id id);
+
+	//! Sets small value (without GYS_user_val), can be used with lvalue.
+	void set_small_val(char val, GYS_type_id id);
+
+	//! Sets small value (without GYS_user_val), can be used with lvalue.
+	void set_small_val(int val, GYS_type_id id);
+
+	//! Sets small value (without GYS_user_val), can be used with lvalue.
+	void set_small_val(double val, GYS_type_id id);
+
 	//! Sets user data calling store() defined by user, cleans lvalue.
     /*!
 	  \param user_val user data.
@@ -215,7 +321,7 @@ public:
 
 	//! Gets pointer to user value.
     /*!
-	  \return Pointer to user value.
+	  \return Pointer to user value (0 - for small value, see set_small_val()).
 	  \see get_user_val()
     */
 	GYS_user_val* get_ptr_to_user_val() const;
@@ -227,108 +333,277 @@ public:
 	GYS_ret_val get_value() const;
 };
 
-//:::::::::::::::::::::::::::::::::::::::::Operators (not for user):::::::::::::::::::::::::::::::::::::::::
-// @ - operator
-
-// a@ b
+//:::::::::::::::::::::::::::::::::::::::::Dispatch tables (not for user):::::::::::::::::::::::::::::::::::::::::
 /*!
   \internal
-  \brief Binary operator specifier.
+  \brief Dense table indexed by two small integers (operator code and type id or two type ids).
+
+  Empty entry is T() (e.g. null callback), the table grows when entries are set.
 */
-class GYS_binary_op
+template<class T> class GYS_dispatch_table
 {
 private:
-	string name;     // @
-	string l_type;	 // l-operand's type
+	vector< vector<T> > rows;
 
 public:
-	GYS_binary_op()
-		: name(""), l_type(gys_void_type) {}
+	inline T get(int row, int col) const
+	{
+		if((unsigned)row<rows.size() && (unsigned)col<rows[row].size())
+			return rows[row][col];
+
+		return T();
+	}
+
+	void set(int row, int col, const T& entry)
+	{
+		if((unsigned)row>=rows.size())
+			rows.resize(row+1);
+		if((unsigned)col>=rows[row].size())
+			rows[row].resize(col+1, T());
 
-	GYS_binary_op(string opname, string ltype)
-		 : name(opname), l_type(ltype) {}
+		rows[row][col]=entry;
+	}
 
-	inline string get_comp_name() const // for <
+	void clear()
 	{
-		return name+l_type;
+		rows.clear();
+	}
+
+	void clear(int row) // entries of the row become empty
+	{
+		if((unsigned)row<rows.size())
+			rows[row].clear();
 	}
 };
 
-bool operator<(const GYS_binary_op l, const GYS_binary_op r); //!< For inner map implementation (<b>not for user</b>).
+//:::::::::::::::::::::::::::::::::::::::::Hash tables (not for user):::::::::::::::::::::::::::::::::::::::::
+static const unsigned long gys_hash_seed=2166136261UL; // hash of empty string
 
-// @a
 /*!
   \internal
-  \brief Unary prefix operator specifier.
+  \brief Adds the char to the hash of a string (FNV-1a), the lexer hashes names while reading them.
 */
-class GYS_pre_unary_op
+inline unsigned long gys_hash_char(unsigned long hash, char ch)
 {
-private:
-	string name;     // @
-	string ret_type; // return value type
-
-public:
-	GYS_pre_unary_op()
-		: name(""), ret_type(gys_void_type) {}
+	return (hash^(unsigned char)ch)*16777619UL;
+}
 
-	GYS_pre_unary_op(string opname, string rettype)
-		: name(opname), ret_type(rettype) {}	
+/*!
+  \internal
+  \brief Hash of the string (the same as the lexer's one).
+*/
+inline unsigned long gys_str_hash(const string& str)
+{
+	unsigned long hash=gys_hash_seed;
 
-	inline string get_comp_name() const // for <
-	{
-		return name+ret_type;
-	}
-};
+	for(size_t i=0; i<str.size(); i++)
+		hash=gys_hash_char(hash, str[i]);
 
-bool operator<(const GYS_pre_unary_op l, const GYS_pre_unary_op r); //!< For inner map implementation (<b>not for user</b>).
+	return hash;
+}
 
-// a@
 /*!
   \internal
-  \brief Unary postfix operator specifier.
+  \brief Hash table with string keys (open addressing, linear probing).
+
+  Slots keep the hashes, so probing doesn't touch the entries till the hashes are equal.
+  Entries are allocated separately and never move (pointers to values are valid till erase()).
+  The interface is the used part of std::map's one, find() and insert() can take precomputed hash.
 */
-class GYS_post_unary_op
+template<class T> class GYS_hash_map
 {
+public:
+	typedef pair<const string, T> value_type;
+
 private:
-	string name;   // @
-	string l_type; // operand's type
+	struct slot
+	{
+		unsigned long hash;  // 0 - empty, other - erased if there is no entry
+		value_type*   entry;
+	};
+
+	vector<slot> slots; // size is 0 or power of 2
+	size_t       count; // entries
+	size_t       used;  // entries and erased slots (at most half of the slots)
+
+	size_t next(size_t i) const // first entry from i
+	{
+		while(i<slots.size() && !slots[i].entry)
+			i++;
+
+		return i;
+	}
+
+	void rehash(size_t size)
+	{
+		vector<slot> old;
+		old.swap(slots);
+
+		slot empty={0, 0};
+		slots.resize(size, empty);
+
+		for(size_t i=0; i<old.size(); i++)
+			if(old[i].entry)
+			{
+				size_t j=old[i].hash&(size-1);
+				while(slots[j].entry)
+					j=(j+1)&(size-1);
+
+				slots[j]=old[i];
+			}
+
+		used=count;
+	}
+
+	void copy(const GYS_hash_map& m)
+	{
+		slots=m.slots;
+		count=m.count;
+		used=m.used;
+
+		for(size_t i=0; i<slots.size(); i++)
+			if(slots[i].entry)
+				slots[i].entry=new value_type(*slots[i].entry);
+	}
 
 public:
-	GYS_post_unary_op() : name(""), l_type(gys_void_type) {}
+	class iterator
+	{
+	private:
+		GYS_hash_map* table;
+		size_t        i;
+
+		friend class GYS_hash_map<T>;
+
+		iterator(GYS_hash_map* map_table, size_t index) : table(map_table), i(index) {}
+
+	public:
+		iterator() : table(0), i(0) {}
+
+		value_type& operator*() const { return *table->slots[i].entry; }
+		value_type* operator->() const { return table->slots[i].entry; }
+
+		iterator& operator++() { i=table->next(i+1); return *this; }
+
+		bool operator==(const iterator& it) const { return i==it.i; }
+		bool operator!=(const iterator& it) const { return i!=it.i; }
+	};
 
-	GYS_post_unary_op(string opname, string ltype) : name(opname), l_type(ltype) {}	
+	friend class iterator;
 
-	inline string get_comp_name() const  // for <
+	GYS_hash_map() : count(0), used(0) {}
+	GYS_hash_map(const GYS_hash_map& m) { copy(m); }
+	~GYS_hash_map() { clear(); }
+
+	GYS_hash_map& operator=(const GYS_hash_map& m)
 	{
-		return name+l_type;
+		if(this!=&m)
+		{
+			clear();
+			copy(m);
+		}
+
+		return *this;
 	}
-};
 
-bool operator<(const GYS_post_unary_op l, const GYS_post_unary_op r); //!< For inner map implementation (<b>not for user</b>).
+	iterator begin() { return iterator(this, next(0)); }
+	iterator end()   { return iterator(this, slots.size()); }
 
-//:::::::::::::::::::::::::::::::::::::::::Converter (not for user):::::::::::::::::::::::::::::::::::::::::
-/*!
-  \internal
-  \brief Converter specifier.
-*/
+	size_t size() const     { return count; }
+	size_t max_size() const { return slots.max_size()/2; }
 
-class GYS_converter
-{
-private:
-	string from_type, into_type;
+	iterator find(const string& key) { return find(key, gys_str_hash(key)); }
 
-public:
-	GYS_converter() : from_type(gys_void_type), into_type(gys_void_type) {}
-	
-	GYS_converter(string from, string into) : from_type(from), into_type(into) {}
+	inline iterator find(const string& key, unsigned long hash)
+	{
+		if(count)
+		{
+			size_t mask=slots.size()-1;
+
+			for(size_t i=hash&mask; ; i=(i+1)&mask)
+			{
+				const slot& s=slots[i];
+
+				if(s.entry)
+				{
+					if(s.hash==hash && s.entry->first==key)
+						return iterator(this, i);
+				}
+				else if(!s.hash) // empty
+					break;
+			}
+		}
+
+		return end();
+	}
+
+	pair<iterator, bool> insert(const value_type& v) { return insert(v, gys_str_hash(v.first)); }
+
+	pair<iterator, bool> insert(const value_type& v, unsigned long hash) // doesn't replace the value
+	{
+		iterator it=find(v.first, hash);
+		if(it!=end())
+			return make_pair(it, false);
+
+		if((used+1)*2>slots.size())
+		{
+			size_t size=8;
+			while(size<(count+1)*4)
+				size*=2;
+
+			rehash(size);
+		}
+
+		size_t mask=slots.size()-1, i=hash&mask;
+		while(slots[i].entry)
+			i=(i+1)&mask;
+
+		if(!slots[i].hash) // wasn't erased
+			used++;
+
+		slots[i].hash=hash;
+		slots[i].entry=new value_type(v);
+		count++;
+
+		return make_pair(iterator(this, i), true);
+	}
 
-	inline string get_comp_name() const // for <
+	template<class It> void insert(It first, It last)
 	{
-		return from_type+into_type;
+		for(; first!=last; ++first)
+			insert(*first);
 	}
-};
 
-bool operator<(const GYS_converter l, const GYS_converter r); //!< For inner map implementation (<b>not for user</b>).
+	T& operator[](const string& key) { return insert(value_type(key, T())).first->second; }
+
+	size_t erase(const string& key)
+	{
+		iterator it=find(key);
+		if(it==end())
+			return 0;
+
+		slot& s=slots[it.i];
+		delete s.entry;
+		s.entry=0;
+		s.hash=1; // erased
+		count--;
+
+		return 1;
+	}
+
+	void clear() // slots are kept for the next entries
+	{
+		slot empty={0, 0};
+
+		for(size_t i=0; i<slots.size(); i++)
+		{
+			delete slots[i].entry;
+			slots[i]=empty;
+		}
+
+		count=used=0;
+	}
+};
 
 //:::::::::::::::::::::::::::::::::::::::::Functions for GYS-derived language definition:::::::::::::::::::::::::::::::::::::::::
 
@@ -346,11 +621,29 @@ typedef GYS_ret_val(*GYS_POST_UNARY_OP_FUNC_PTR)(GYS*, GYS_ret_val);          //
 
 typedef GYS_ret_val(*GYS_CONVERTER_PTR)(GYS*, GYS_ret_val); //!< Processes GYS-converter.
 
+typedef bool(*GYS_FUNC_COMPILER_PTR)(GYS*, GYS_compiler*);            //!< Compiles built-in function into the bytecode.
+typedef GYS_ret_val(*GYS_RESUME_FUNC_PTR)(GYS*, GYS_ret_val, const long*); //!< Continues compiled built-in function by interpretation.
+
 typedef void(*GYS_WARNING_FUNC_PTR)(GYS*, string, string);     //!< Warning handler.
 typedef void(*GYS_ERROR_FUNC_PTR)(GYS*, string, string);       //!< Error handler.
 typedef void(*GYS_FATAL_ERROR_FUNC_PTR)(GYS*, string, string); //!< Fatal error handler.
 /*@}*/
 
+// a@ b
+/*!
+  \internal
+  \brief Binary operator callback and its right operand type.
+*/
+struct GYS_binary_op
+{
+	GYS_type_id            r_type; // r-operand's type
+	GYS_BINARY_OP_FUNC_PTR func;   // 0 - operator isn't defined
+
+	GYS_binary_op() : r_type(gys_void_type_id), func(0) {}
+
+	GYS_binary_op(GYS_type_id rtype, GYS_BINARY_OP_FUNC_PTR pf) : r_type(rtype), func(pf) {}
+};
+
 //:::::::::::::::::::::::::::::::::::::::::standard error and warning handlers:::::::::::::::::::::::::::::::::::::::::
 
 void std_gys_warning_callback(GYS* s, string str1, string str2); //!< Standard warning handler.
@@ -371,11 +664,587 @@ enum GYS_tok_type{
 	GYS_EOF        /*!< End of input. */
 };
 
+//:::::::::::::::::::::::::::::::::::::::::Delimeter codes:::::::::::::::::::::::::::::::::::::::::
+//! Delimeter codes (see GYS::get_tok_code()).
+enum GYS_delim{
+	GYS_NO_DELIM,      /*!< Token isn't a delimeter. */
+
+	// one-char delimeters (in the order of lexer's delimeter set)
+	GYS_SEMICOLON,     /*!< ; */
+	GYS_COLON,         /*!< : */
+	GYS_COMMA,         /*!< , */
+	GYS_LPAREN,        /*!< ( */
+	GYS_RPAREN,        /*!< ) */
+	GYS_LBRACE,        /*!< { */
+	GYS_RBRACE,        /*!< } */
+	GYS_LBRACKET,      /*!< [ */
+	GYS_RBRACKET,      /*!< ] */
+	GYS_LESS,          /*!< < */
+	GYS_GREATER,       /*!< > */
+	GYS_ASSIGN,        /*!< = */
+	GYS_PLUS,          /*!< + */
+	GYS_MINUS,         /*!< - */
+	GYS_MUL,           /*!< * */
+	GYS_BIT_AND,       /*!< & */
+	GYS_BIT_OR,        /*!< | */
+	GYS_NOT,           /*!< ! */
+	GYS_MOD,           /*!< % */
+	GYS_CARET,         /*!< ^ */
+	GYS_SHARP,         /*!< # */
+	GYS_TILDE,         /*!< ~ */
+	GYS_DOT,           /*!< . */
+	GYS_DIV,           /*!< / */
+
+	// several-char delimeters
+	GYS_EQUAL,         /*!< == */
+	GYS_NOT_EQUAL,     /*!< != */
+	GYS_IDENT,         /*!< === */
+	GYS_NOT_IDENT,     /*!< !== */
+	GYS_LESS_EQ,       /*!< <= */
+	GYS_GREATER_EQ,    /*!< >= */
+	GYS_DEF_ASSIGN,    /*!< := */
+	GYS_PLUS_ASSIGN,   /*!< += */
+	GYS_MINUS_ASSIGN,  /*!< -= */
+	GYS_MUL_ASSIGN,    /*!< *= */
+	GYS_DIV_ASSIGN,    /*!< /= */
+	GYS_MOD_ASSIGN,    /*!< %= */
+	GYS_SHL_ASSIGN,    /*!< <<= */
+	GYS_SHR_ASSIGN,    /*!< >>= */
+	GYS_SHL,           /*!< << */
+	GYS_SHR,           /*!< >> */
+	GYS_INC,           /*!< ++ */
+	GYS_DEC,           /*!< -- */
+	GYS_AND,           /*!< && */
+	GYS_OR,            /*!< || */
+	GYS_ARROW,         /*!< -> */
+
+	GYS_DELIM_NUM      /*!< Number of codes (not a delimeter). */
+};
+
+//! Gets delimeter code by its external representation.
+/*!
+  \param str delimeter (e.g. "+=").
+  \return Delimeter code or GYS_NO_DELIM if <tt>str</tt> isn't a delimeter.
+*/
+GYS_delim gys_delim_code(const string& str);
+
+//! Gets external representation of the delimeter.
+/*!
+  \param code delimeter code.
+  \return Delimeter string ("" for GYS_NO_DELIM).
+*/
+const char* gys_delim_str(GYS_delim code);
+
+//:::::::::::::::::::::::::::::::::::::::::Expression trees (not for user):::::::::::::::::::::::::::::::::::::::::
+struct GYS_expr_node;
+
+/*!
+  \internal
+  \brief Operator in the expression tree (see GYS_COMPILE).
+*/
+struct GYS_expr_op
+{
+	GYS_delim      code;   // operator
+	long           pos;    // operator's token index
+	long           end;    // next token index after postfix operator's callback
+	string         r_type; // right operand type (binary operators)
+	GYS_expr_node* rval;   // right operand (binary operators)
+
+	GYS_expr_op(GYS_delim op_code, long op_pos)
+		: code(op_code), pos(op_pos), end(-1), rval(0) {}
+};
+
+/*!
+  \internal
+  \brief Expression tree node kinds.
+*/
+enum GYS_expr_kind{
+	GYS_EXPR_OPS,        // first operand and binary operators of one precedence
+	GYS_EXPR_VAR,        // var
+	GYS_EXPR_GLOBAL_VAR, // var^
+	GYS_EXPR_FUNC,       // built-in function (callback)
+	GYS_EXPR_PRE_UNARY,  // @operand
+	GYS_EXPR_PAREN,      // (expr)
+	GYS_EXPR_RAW         // raw value (type callback)
+};
+
+/*!
+  \internal
+  \brief Expression tree node, recorded on the first interpretation (see GYS_COMPILE).
+*/
+struct GYS_expr_node
+{
+	GYS_expr_kind       kind;
+	int                 level;    // analyzer level: 1..8 - binary operators, 9 - primary
+	long                pos;      // first token index
+	long                end;      // index of the token after the expression
+	long                head_end; // next token index after primary's callback
+	GYS_delim           code;     // prefix operator
+	string              name;     // variable name
+	GYS_expr_node*      sub;      // first operand, (expr) or prefix operator's operand
+	vector<GYS_expr_op> ops;      // binary operators or postfix operators of primary
+
+	GYS_expr_node(GYS_expr_kind node_kind, int node_level, long node_pos)
+		: kind(node_kind), level(node_level), pos(node_pos), end(node_pos), head_end(-1),
+		  code(GYS_NO_DELIM), sub(0) {}
+
+	~GYS_expr_node();
+};
+
+//:::::::::::::::::::::::::::::::::::::::::Generations and caches (not for user):::::::::::::::::::::::::::::::::::::::::
+/*!
+  \internal
+  \brief Generation of changeable data (names of a variable map, language definition).
+
+  It's changed when the data change. Generations are unique for all the objects
+  (copies get new ones), so the same generation means the same object with the same data.
+*/
+class GYS_generation
+{
+private:
+	unsigned long gen;
+	static unsigned long last_gen;
+
+public:
+	GYS_generation() : gen(++last_gen) {}
+	GYS_generation(const GYS_generation&) : gen(++last_gen) {}
+	GYS_generation& operator=(const GYS_generation&) { gen=++last_gen; return *this; }
+
+	void next() { gen=++last_gen; } // data were changed
+	operator unsigned long() const { return gen; }
+};
+
+/*!
+  \internal
+  \brief Variable resolved by name (see GYS::find_var()).
+
+  The cells are valid while the generations of both maps are the same.
+*/
+struct GYS_var_ref
+{
+	pair<GYS_ret_val, bool>* local;  // local variable (0 - none)
+	pair<GYS_ret_val, bool>* global; // global variable (0 - none)
+	unsigned long            local_gen, global_gen;
+
+	GYS_var_ref() : local(0), global(0), local_gen(0), global_gen(0) {}
+
+	pair<GYS_ret_val, bool>* cell() const { return local ? local : global; } // local variable hides global one
+	bool is_const() const { return (local && local->second) || (global && global->second); } // see GYS::is_const()
+};
+
+/*!
+  \internal
+  \brief Inline cache of a bytecode instruction (the last callback found for the operand type).
+
+  The callback is valid while the generation of the language definition is the same (see GYS::own_lang()).
+*/
+struct GYS_inline_cache
+{
+	unsigned long gen;    // generation of GYS_language (0 - empty)
+	GYS_type_id   type;   // (left) operand type (FIND_BINARY, CONVERT, QUICK_*)
+	GYS_type_id   r_type; // right operand type (QUICK_BINARY)
+
+	union
+	{
+		GYS_BINARY_OP_FUNC_PTR     binary;
+		GYS_PRE_UNARY_OP_FUNC_PTR  pre_unary;
+		GYS_POST_UNARY_OP_FUNC_PTR post_unary;
+		GYS_CONVERTER_PTR          converter;
+		GYS_FUNC_PTR               func;
+	};
+
+	GYS_inline_cache() : gen(0), type(gys_void_type_id), r_type(gys_void_type_id), func(0) {}
+};
+
+//:::::::::::::::::::::::::::::::::::::::::Bytecode (not for user):::::::::::::::::::::::::::::::::::::::::
+/*!
+  \internal
+  \brief Bytecode instructions (see GYS_COMPILE).
+
+  r[] - registers of the call frame, f[] - operator callbacks found by FIND_* instructions,
+  strs[] - names and types of the code, pos/end - token indices.
+*/
+enum GYS_opcode{
+	GYS_OP_LOAD_VAR,       // r[a]=var strs[k] (resolved by var_refs[c])
+	GYS_OP_LOAD_GLOBAL,    // r[a]=var^ strs[k] (resolved by var_refs[c])
+	GYS_OP_CALL_FUNC,      // r[a]=built-in function at pos (its callback has to read tokens till end)
+	GYS_OP_RAW,            // r[a]=raw value of type strs[k] at pos (type callback has to read tokens till end)
+	GYS_OP_FIND_BINARY,    // f[c]=binary operator b for r[a] with right operand of type strs[k]
+	GYS_OP_BINARY,         // r[a]=f[c](r[a], r[b]) (k - operator code)
+	GYS_OP_FIND_PRE_UNARY, // f[c]=prefix unary operator b returning strs[k]
+	GYS_OP_PRE_UNARY,      // r[a]=f[c](r[a]) (result must be of type strs[k])
+	GYS_OP_POST_UNARY,     // r[a]=postfix unary operator at pos (its callback has to read tokens till end)
+	GYS_OP_QUICK_POST_UNARY, // quickened POST_UNARY: quick operator for the operand type (see GYS::add_quick_post_unary_op())
+	GYS_OP_CONVERT,        // r[a]=r[a] converted into strs[k] (b!=0 - right operand of the next BINARY)
+	GYS_OP_QUICK_BINARY,   // quickened CONVERT and the next BINARY: quick operator for the operand types (see GYS::add_quick_binary_op())
+	GYS_OP_SYNC,           // token at pos becomes the current putbacked one
+	GYS_OP_CLEAR,          // r[a]=void
+	GYS_OP_VALUE,          // r[a]=value of r[a] (the operand of [] is only read, its lvalue isn't needed)
+	GYS_OP_JUMP,           // goto k
+	GYS_OP_JUMP_FALSE,     // if(!r[a]) goto k
+	GYS_OP_JUMP_TRUE,      // if(r[a]) goto k
+	GYS_OP_FOLD,           // r[a]=folds[c].val and goto folds[c].target if the value is valid (see GYS::opt_fold())
+	GYS_OP_FOLD_STORE,     // folds[c].val=r[a] if the instructions after FOLD didn't report errors or warnings
+	GYS_OP_HOIST,          // r[a]=r[b] and goto k if the frame's hoisted value c is valid (see GYS::opt_hoist())
+	GYS_OP_HOIST_STORE,    // r[b]=r[a] if the function call after HOIST didn't report errors or warnings
+	GYS_OP_CHECK_FUNC,     // built-in function strs[k] must be processed by funcs[c]
+	GYS_OP_CHECK_VAR,      // var strs[k] must be of type strs[b] (resolved by var_refs[c])
+	GYS_OP_CHECK_FINISHED, // leaves the code if the script is finished
+	GYS_OP_RETURN,         // script returns r[a] (finishes the script)
+	GYS_OP_LEAVE,          // leaves the code (the token before pos becomes the current one)
+	GYS_OP_END             // returns r[a], the token at pos becomes the current putbacked one
+};
+
+/*!
+  \internal
+  \brief Bytecode instruction.
+*/
+struct GYS_instr
+{
+	GYS_opcode op;
+	int        a, b, c, k; // operands (see GYS_opcode)
+	long       pos, end;   // token indices
+	int        exit;       // how to leave the code if the instruction fails (index in GYS_code::exits, -1 - none)
+	int        cache;      // inline cache (index in GYS_code::caches, -1 - none)
+
+	GYS_instr(GYS_opcode code, long start_pos)
+		: op(code), a(0), b(0), c(0), k(0), pos(start_pos), end(-1), exit(-1), cache(-1) {}
+};
+
+/*!
+  \internal
+  \brief Continuation kinds (what interpreter does with the value when it leaves the code).
+*/
+enum GYS_cont_kind{
+	GYS_CONT_LOOP,      // binary operators of the level (get_expr_loop())
+	GYS_CONT_PRIM_LOOP, // postfix unary operators and binary [] (get_prim_loop())
+	GYS_CONT_CONVERT,   // conversion into type
+	GYS_CONT_BINARY,    // binary operator f[func] with the left operand r[reg]
+	GYS_CONT_INDEX,     // "]" of binary []
+	GYS_CONT_PRE_UNARY, // prefix unary operator f[func] returning type
+	GYS_CONT_PAREN,     // ")" of (expr)
+	GYS_CONT_RESUME     // compiled built-in function's resume callback
+};
+
+/*!
+  \internal
+  \brief Continuation (the outer ones are linked by parent indices).
+*/
+struct GYS_cont
+{
+	GYS_cont_kind       kind;
+	int                 parent; // outer continuation (-1 - none)
+	int                 level;  // analyzer level (LOOP)
+	int                 reg;    // left operand (BINARY)
+	int                 func;   // operator callback (BINARY, PRE_UNARY)
+	GYS_delim           code;   // operator (PRE_UNARY)
+	int                 type;   // type name in strs (CONVERT, PRE_UNARY)
+	GYS_RESUME_FUNC_PTR resume; // callback (RESUME)
+	long                args[6];
+
+	GYS_cont(GYS_cont_kind cont_kind, int parent_cont)
+		: kind(cont_kind), parent(parent_cont), level(0), reg(0), func(0), code(GYS_NO_DELIM), type(0), resume(0) {}
+};
+
+/*!
+  \internal
+  \brief How interpretation leaves the code.
+*/
+enum GYS_exit_kind{
+	GYS_EXIT_VALUE, // continues with r[reg] (from pos if pos>=0)
+	GYS_EXIT_PRIM,  // interpretes primary expression of type from pos
+	GYS_EXIT_STMT,  // interpretes statement from pos
+	GYS_EXIT_VOID   // continues with void value (the token before pos becomes the current one)
+};
+
+/*!
+  \internal
+  \brief Exit from the code.
+*/
+struct GYS_exit
+{
+	GYS_exit_kind kind;
+	int           reg;
+	long          pos;
+	int           type;  // type name in strs (PRIM)
+	int           cont;  // continuations
+	bool          stale; // code doesn't fit anymore (recompile it)
+};
+
+static const int gys_max_code_versions=4; // recompilations of the code which was left
+static const int gys_max_inline_instrs=32; // bigger compiled function bodies aren't inlined (see GYS_OPT_INLINE)
+
+/*!
+  \internal
+  \brief Value computed by contiguous instructions [start, end) into reg (recorded for the optimizer passes).
+*/
+struct GYS_value_block
+{
+	long start, end;
+	int  reg;
+};
+
+/*!
+  \internal
+  \brief Folded constant value (FOLD, FOLD_STORE).
+
+  The value is valid while the language, the variable names and the global variable names are the same.
+*/
+struct GYS_fold
+{
+	GYS_ret_val   val;
+	unsigned long gen, var_gen, global_gen; // generations when the value was stored (gen==0 - empty)
+	long          reports; // errors and warnings before the folded instructions
+	vector<int>   vars;    // constants read by the instructions (var_refs)
+	long          skip;    // instruction after FOLD_STORE
+	long          jump;    // conditional jump on the value after FOLD_STORE (-1 - none, see GYS::opt_branch())
+	long          target;  // where the instruction after FOLD continues with the value
+
+	GYS_fold() : gen(0), var_gen(0), global_gen(0), reports(0), skip(0), jump(-1), target(0) {}
+};
+
+/*!
+  \internal
+  \brief Hoisted call of pure built-in function (HOIST, HOIST_STORE).
+*/
+struct GYS_hoist
+{
+	GYS_FUNC_PTR func; // pure function
+	vector<int>  vars; // local variables read by the call (strs)
+};
+
+/*!
+  \internal
+  \brief Compiled code of the expression or the built-in function.
+*/
+class GYS_code : public RefCntObject
+{
+public:
+	vector<GYS_instr>    instrs;
+	vector<string>       strs;  // names and types
+	vector<unsigned long> str_hashes; // their hashes (see gys_str_hash())
+	vector<GYS_type_id>  types; // ids of the types in strs
+	vector<GYS_FUNC_PTR> funcs; // built-in functions (CHECK_FUNC)
+	vector<GYS_var_ref>  var_refs; // variables (LOAD_VAR, LOAD_GLOBAL, CHECK_VAR)
+	vector<GYS_inline_cache> caches; // callbacks (FIND_*, CONVERT, CALL_FUNC, CHECK_*)
+	vector<GYS_value_block> blocks; // values of the expressions (until the code is optimized)
+	vector<GYS_fold>     folds;
+	vector<GYS_hoist>    hoists;
+	vector<GYS_cont>     conts;
+	vector<GYS_exit>     exits;
+	int                  reg_num, op_num; // registers and operator callbacks used
+	long                 pos;        // first token index
+	long                 expr_count; // number of trees when compiled
+	bool                 stale;      // code was left because it doesn't fit anymore
+	int                  running;    // number of active executions
+	string               name;
+
+	GYS_code(long start_pos, string code_name)
+		: reg_num(0), op_num(0), pos(start_pos), expr_count(0), stale(false), running(0), name(code_name) {}
+
+	int add_str(const string& str);   // returns index in strs
+	int add_type(const string& type); // the same with type id
+
+	void dump(ostream& out, const GYS_token_buf* buf) const; // disassembly
+};
+
+/*!
+  \internal
+  \brief Registers and operator callbacks of the running code.
+*/
+struct GYS_vm_frame
+{
+	union op_func
+	{
+		GYS_BINARY_OP_FUNC_PTR    binary;
+		GYS_PRE_UNARY_OP_FUNC_PTR pre_unary;
+	};
+
+	//! Hoisted value of the frame (valid while the generations are the same).
+	struct hoisted
+	{
+		unsigned long gen, var_gen;
+		long          reports; // errors and warnings before the call
+
+		vector<GYS_ret_val*> vars; // values of the variables of the arguments (valid while var_gen is the same)
+	};
+
+	vector<GYS_ret_val> regs;
+	vector<op_func>     ops;
+	vector<hoisted>     hoists;
+};
+
+//:::::::::::::::::::::::::::::::::::::::::Token array (not for user):::::::::::::::::::::::::::::::::::::::::
+/*!
+  \internal
+  \brief Lexed token (see GYS_PRETOKENIZE).
+*/
+struct GYS_token
+{
+	GYS_tok_type type;   // token type
+	GYS_delim    code;   // delimeter code
+	int          text;   // interned external representation
+	double       val;    // double value (GYS_DOUBLE)
+	long         offset; // offset of the first char in the input (-1 if unknown)
+	long         line;   // line number after reading the token
+};
+
+/*!
+  \internal
+  \brief Token array filled by the lexer (each token is lexed only once).
+*/
+class GYS_token_buf : public RefCntObject
+{
+public:
+	vector<GYS_token> toks;    // tokens in input order
+	vector<string>    texts;   // interned token texts
+	vector<unsigned long> text_hashes; // their hashes (see gys_str_hash())
+	GYS_hash_map<int> text_ids;
+	bool              complete; // EOF is in the array
+
+	struct expr
+	{
+		string                 type;
+		GYS_expr_node*         node;
+		RefCntPointer<GYS_code> code;
+		int                    versions; // times the code was compiled
+	};
+
+	struct func_code
+	{
+		GYS_FUNC_COMPILER_PTR  pf;
+		RefCntPointer<GYS_code> code;
+		int                    versions;   // times the code was compiled
+		long                   fail_count; // expr_count when the compilation failed (-1 - never)
+	};
+
+	vector< vector<expr> >      exprs;      // compiled expressions by token index and type
+	vector< vector<func_code> > func_codes; // compiled built-in functions by token index
+	long                        expr_count; // number of trees
+	struct odd_end
+	{
+		GYS_delim end;
+		long      pos; // 0 - not found yet
+	};
+
+	vector<odd_end>             odd_ends;   // odd end-delimeters after the tokens (see GYS::move_to_odd())
+	vector<GYS_var_ref>         var_refs;   // variables by token index (see GYS::get_prim())
+
+	GYS_token_buf() : complete(false), expr_count(0) {}
+	~GYS_token_buf();
+
+	int intern(const string& str, unsigned long hash); // returns text id
+
+	expr* find_expr(long pos, const string& type);
+	void add_expr(long pos, const string& type, GYS_expr_node* node);
+
+	func_code& get_func_code(long pos, GYS_FUNC_COMPILER_PTR pf);
+
+	GYS_var_ref& get_var_ref(long pos);
+};
+
+//:::::::::::::::::::::::::::::::::::::::::Language definition (not for user):::::::::::::::::::::::::::::::::::::::::
+/*!
+  \internal
+  \brief Built-in functions, types, operators and converters of the language.
+
+  Sub-scripts share the object of their super script (see GYS::copy_params_to_sub()),
+  it's copied only when a script changes the shared definition (see GYS::own_lang()).
+*/
+class GYS_language : public RefCntObject
+{
+public:
+	typedef GYS_hash_map<GYS_FUNC_PTR>                    GYS_func_map; 
+	typedef GYS_hash_map<GYS_TYPE_FUNC_PTR>               GYS_type_func_map;
+	typedef GYS_dispatch_table<GYS_binary_op>             GYS_binary_op_table;     // [operator code][l-operand type]
+	typedef GYS_dispatch_table<GYS_PRE_UNARY_OP_FUNC_PTR> GYS_pre_unary_op_table;  // [operator code][return type]
+	typedef GYS_dispatch_table<GYS_POST_UNARY_OP_FUNC_PTR> GYS_post_unary_op_table; // [operator code][operand type]
+	typedef GYS_dispatch_table<GYS_CONVERTER_PTR>         GYS_converter_table;     // [from type][into type]
+	typedef GYS_dispatch_table<GYS_BINARY_OP_FUNC_PTR>    GYS_quick_binary_op_table; // [l-operand type][r-operand type] of an operator
+	typedef map<string, GYS_FUNC_COMPILER_PTR>            GYS_func_compiler_map;
+	typedef map<string, GYS_FUNC_PTR>                     GYS_pure_func_map;       // [name] - function declared pure
+
+	GYS_func_map            func_map; 
+	GYS_type_func_map       type_func_map; 
+	GYS_binary_op_table     binary_op_table;
+	GYS_pre_unary_op_table  pre_unary_op_table;
+	GYS_post_unary_op_table post_unary_op_table;
+	GYS_converter_table     converter_table;
+	GYS_func_compiler_map   func_compiler_map;
+	GYS_pure_func_map       pure_func_map; // see GYS::add_pure_gys_func()
+
+	vector<GYS_quick_binary_op_table> quick_binary_op_tables;  // [operator code] (see GYS::add_quick_binary_op())
+	GYS_post_unary_op_table           quick_post_unary_op_table; // [operator code][operand type]
+	GYS_generation          gen; // changed by GYS::own_lang() (see GYS_inline_cache)
+};
+
+//:::::::::::::::::::::::::::::::::::::::::Shared source code:::::::::::::::::::::::::::::::::::::::::
+//! Code interpreted by many sub-scripts (e.g. function body).
+/*!
+	In GYS_PRETOKENIZE mode the code is lexed and compiled once: all the sub-scripts
+	started by GYS::begin_call() share its token array with the compiled expressions.
+	Objects of this class are used by pointers (RefCntPointer), the code can't be changed.
+*/
+class GYS_source : public RefCntObject
+{
+private:
+	string text;
+	istringstream in;                     // input of the lexer of the shared token array
+	RefCntPointer<GYS_token_buf> tok_buf; // 0 - isn't lexed yet
+	bool          inlined;    // the code can be inlined (see GYS::is_inline_code())
+	unsigned long inline_gen; // language generation when it was checked (0 - never)
+
+	friend class GYS;
+
+public:
+	//! Constructor.
+    /*!
+	  \param code source code.
+    */
+	GYS_source(const string& code) : text(code), in(code), inlined(false), inline_gen(0) {}
+
+	//! Gets source code.
+    /*!
+	  \return Source code.
+    */
+	const string& get_text() const { return text; }
+};
+
+//:::::::::::::::::::::::::::::::::::::::::Call frames (not for user):::::::::::::::::::::::::::::::::::::::::
+/*!
+  \internal
+  \brief Sub-script of a call with its input, reused by the next calls (see GYS::begin_call()).
+
+  Every script keeps the frame of the next call level, so recursion of depth N creates N scripts once.
+*/
+class GYS_call_frame
+{
+public:
+	GYS*          script; // 0 - not created yet
+	istringstream in;     // input of the script
+	bool          busy;   // the script is running
+	bool          bound;  // the script keeps its variables for the next call of the code (see GYS_OPT_INLINE)
+	RefCntPointer<GYS_source> code; // code of the last call
+
+	GYS_call_frame() : script(0), busy(false), bound(false) {}
+	GYS_call_frame(const GYS_call_frame&) : script(0), busy(false), bound(false) {} // copies are empty (e.g. script for a thread)
+	GYS_call_frame& operator=(const GYS_call_frame&) { return *this; }
+	~GYS_call_frame();
+};
+
 //::::::::::::::::::::::::::::::::::::::::::::Flags::::::::::::::::::::::::::::::::::::::::::::
 //! State flags.
 enum GYS_flag{
 	GYS_ESC,                /*!< Check escape sequences in string- and char-tokens. */
 	GYS_GLOBAL_VAR_OP,      /*!< Use built-in global var operator (var^.) */
+	GYS_PRETOKENIZE,        /*!< Lex input once into the token array (positions become token indices), disabled by default. */
+	GYS_COMPILE,            /*!< Compile expressions into trees on the first pass and run their bytecode later (sets GYS_PRETOKENIZE), disabled by default. */
+	GYS_DUMP_BYTECODE,      /*!< Print the bytecode into clog when it's compiled (GYS_COMPILE mode), disabled by default. */
+	GYS_OPT_FOLD,           /*!< Optimizer pass: fold constant expressions (GYS_COMPILE mode), enabled by default. */
+	GYS_OPT_BRANCH,         /*!< Optimizer pass: skip the branches with folded conditions (needs GYS_OPT_FOLD), enabled by default. */
+	GYS_OPT_HOIST,          /*!< Optimizer pass: call pure built-in functions once per code run (GYS_COMPILE mode), enabled by default. */
+	GYS_OPT_INLINE,         /*!< Calls of small functions returning an expression keep their sub-script bound to the body (GYS_COMPILE mode), enabled by default. */
+	GYS_OPT_TAIL_CALL,      /*!< Function calls in tail position ("return f(...)") are made by the caller in the same call frame (GYS_COMPILE mode), enabled by default. */
 };
 
 //! GYS interpreter class.
@@ -386,13 +1255,10 @@ enum GYS_flag{
 class GYS
 {
 private:
-	typedef map<string, GYS_FUNC_PTR>                                  GYS_func_map; 
-	typedef map<string, GYS_TYPE_FUNC_PTR>                             GYS_type_func_map;
-	typedef map< string, pair<GYS_ret_val, bool> >                     GYS_var_map;
-	typedef map< GYS_binary_op, pair<string, GYS_BINARY_OP_FUNC_PTR> > GYS_binary_op_map;
-	typedef map<GYS_pre_unary_op, GYS_PRE_UNARY_OP_FUNC_PTR>           GYS_pre_unary_op_map;
-	typedef map<GYS_post_unary_op, GYS_POST_UNARY_OP_FUNC_PTR>         GYS_post_unary_op_map;
-	typedef map<GYS_converter, GYS_CONVERTER_PTR>                      GYS_converter_map;
+	typedef GYS_language::GYS_func_map                                      GYS_func_map; 
+	typedef GYS_language::GYS_type_func_map                                 GYS_type_func_map;
+	typedef GYS_hash_map< pair<GYS_ret_val, bool> >                         GYS_var_map;
+	typedef GYS_language::GYS_func_compiler_map                             GYS_func_compiler_map;
 
 	string name;	
 	istream* file; // input
@@ -400,30 +1266,47 @@ private:
 	
 	string token;          // ext. repr. of token
 	GYS_tok_type tok_type; 
+	GYS_delim tok_code;    // delimeter code
+	int tok_id;            // interned text id (GYS_PRETOKENIZE mode only)
+	unsigned long tok_hash; // hash of the name token (see gys_str_hash())
 	double tok_val;        // token double value
 	bool is_putbacked;     
 
-	GYS_func_map          func_map; 
-	GYS_type_func_map     type_func_map; 
-	GYS_var_map           var_map; 
-	GYS_binary_op_map     binary_op_map;
-	GYS_pre_unary_op_map  pre_unary_op_map;
-	GYS_post_unary_op_map post_unary_op_map;
-	GYS_converter_map     converter_map;
-	static GYS_var_map    global_var_map;
+	RefCntPointer<GYS_token_buf> tok_buf; // token array (GYS_PRETOKENIZE mode only)
+	long tok_pos;          // index of the next token in tok_buf
+	long tok_cur;          // index of the current token in tok_buf
+	long tok_offset;       // input offset of the last lexed token
+
+	RefCntPointer<GYS_language> lang; // shared with sub-scripts
+	GYS_var_map             var_map; 
+	GYS_generation          var_gen;        // of var_map
+	static GYS_var_map      global_var_map;
+	static GYS_generation   global_var_gen; // of global_var_map
+
+	deque<GYS_vm_frame> vm_frames; // register files of the running code (GYS_COMPILE mode only)
+	int vm_depth;
 
 	string      ret_type;
 	GYS_ret_val ret_val;
 
 	bool was_finished;
 
+	bool                tail_calls;   // the caller makes the tail calls of this script (see set_tail_call())
+	bool                tail_pending; // the script was finished by a tail call
+	GYS_ret_val         tail_func;
+	vector<GYS_ret_val> tail_args;
+
 	GYS_WARNING_FUNC_PTR     warning_func;
 	GYS_ERROR_FUNC_PTR       error_func;
 	GYS_FATAL_ERROR_FUNC_PTR fatal_error_func;
 
 	GYS* super_script;
+	GYS_call_frame call_frame; // sub-script for the calls from this one
+	bool other_thread;         // the script or its superscript is interpreted by other thread (see copy_params_to_sub())
+
+	bitset<16> flags;
 
-	bitset<8> flags;
+	friend class GYS_compiler;
 
 public:
 	//! Constructor.
@@ -512,6 +1395,8 @@ public:
 
 	//! Enable interpreter's option.
     /*!
+	  \note Enable GYS_PRETOKENIZE and GYS_COMPILE before interpretation starts.
+
 	  \param flag specifies the option to be set.
 	  \return <b>true</b> if flag exists, <b>false</b> otherwise.
 
@@ -599,6 +1484,31 @@ public:
     */
 	bool add_gys_func(string ext_repr, GYS_FUNC_PTR pf); 	                      
 
+	//! Adds compiler of built-in function (GYS_COMPILE mode).
+    /*!
+	  Compiler emits the bytecode which does the same as the built-in function (e.g. loops become jumps).
+	  If it fails the function is called as usual.
+
+	  \param ext_repr function's name.
+	  \param pf compiler.
+
+	  \return <b>true</b> if function exists, <b>false</b> otherwise.
+
+	  \see GYS_compiler, exec_compiled()
+    */
+	bool add_gys_func_compiler(string ext_repr, GYS_FUNC_COMPILER_PTR pf);
+
+	//! Declares built-in function pure (GYS_COMPILE mode).
+    /*!
+	  Pure function's result depends only on its arguments, it doesn't change variables and
+	  doesn't do anything else. Compiled loops call it once if its arguments don't change (see GYS_OPT_HOIST).
+
+	  \param ext_repr function's name.
+
+	  \return <b>true</b> if function exists, <b>false</b> otherwise.
+    */
+	bool add_pure_gys_func(string ext_repr);
+
 	//! Adds new type.
     /*!
 	  \param type_str type name.
@@ -686,6 +1596,40 @@ public:
     */
 	bool add_post_unary_op(string opname, string l_type, GYS_POST_UNARY_OP_FUNC_PTR pf);
 
+	//! Adds quick form of binary operator for the right operand of another type (GYS_COMPILE mode).
+    /*!
+	  Compiled code calls the quick form instead of converting the right operand into
+	  the operator's <tt>r_type</tt> and calling the operator (e.g. int+int without int->double conversion),
+	  so <tt>pf</tt> must give the same result and mustn't read tokens.
+	  Quick forms of the operator are removed by add_binary_op() and remove_binary_op() for the same left operand type.
+
+	  \param opname operator's name (e.g. "+" or "[]").
+	  \param l_type type of the left operand.
+	  \param r_type type of the right operand before conversion.
+	  \param pf user function which processes this operator.
+	  
+	  \return <b>true</b> if function succeeded, <b>false</b> otherwise.
+
+	  \see add_binary_op(), remove_quick_binary_op()
+    */
+	bool add_quick_binary_op(string opname, string l_type, string r_type, GYS_BINARY_OP_FUNC_PTR pf);
+
+	//! Adds quick form of postfix unary operator (GYS_COMPILE mode).
+    /*!
+	  Compiled code calls the quick form without moving to the operator's token,
+	  so <tt>pf</tt> must give the same result as the operator and mustn't read tokens (e.g. ++, but not "(").
+	  Quick form is removed by add_post_unary_op() and remove_post_unary_op() for the same operand type.
+
+	  \param opname operator's name (e.g. "++").
+	  \param l_type type of the left (and the only) operand.
+	  \param pf user function which processes this operator.
+	  
+	  \return <b>true</b> if function succeeded, <b>false</b> otherwise.
+
+	  \see add_post_unary_op(), remove_quick_post_unary_op()
+    */
+	bool add_quick_post_unary_op(string opname, string l_type, GYS_POST_UNARY_OP_FUNC_PTR pf);
+
 	//! Adds new local variable (constant).
     /*!
 	  \note
@@ -773,6 +1717,25 @@ public:
     */
 	void remove_post_unary_op(string opname, string l_type);
 
+	//! Removes quick form of binary operator.
+    /*!
+	  \param opname operator's name (e.g. "+" or "[").
+	  \param l_type type of the left operand.
+	  \param r_type type of the right operand before conversion.
+	
+	  \see add_quick_binary_op()
+    */
+	void remove_quick_binary_op(string opname, string l_type, string r_type);
+
+	//! Removes quick form of postfix unary operator.
+    /*!
+	  \param opname operator's name (e.g. "++").
+	  \param l_type type of the left (and the only) operand.
+	  
+	  \see add_quick_post_unary_op()
+    */
+	void remove_quick_post_unary_op(string opname, string l_type);
+
 	//! Removes local variable.
     /*!
 	  \param var_name variable's name.
@@ -803,6 +1766,14 @@ public:
     */
 	bool exam(string tok);
 
+	//! Gets next token and checks if it's the specified delimeter.
+    /*!
+	  \param code desired delimeter code.
+	  
+	  \return <b>true</b> if function succeeded, <b>false</b> otherwise.
+    */
+	bool exam(GYS_delim code);
+
 	//! Gets next token and checks its type.
     /*!
 	  \param tok_type desired token type.
@@ -811,15 +1782,30 @@ public:
     */
 	bool exam(GYS_tok_type tok_type);
 
+	//! Moves to the odd end-delimeter (current token becomes this end-delimeter).
+    /*!
+	  For example, after "{" was read it skips the block till its "}".
+	  In GYS_PRETOKENIZE mode found end-delimeters are remembered, so the same code is skipped at once next time.
+
+	  \param end end-delimeter code (e.g. GYS_RBRACE).
+	  \param end_pair code of its pair (e.g. GYS_LBRACE).
+	  
+	  \return <b>false</b> if GYS_EOF was found, <b>true</b> otherwise.
+    */
+	bool move_to_odd(GYS_delim end, GYS_delim end_pair);
+
 	//! Puts current token back (<i>once</i>).
     /*!
 	  This function just forces lexer to skip next get_token() call.
 	  It doesn't restore previous token's params.
+	  In GYS_PRETOKENIZE mode the cursor is just moved back to the current token.
     */
 	void putback_tok();
 
 	//! Sets cursor position in the input (<i>low level function</i>).
     /*!
+	  In GYS_PRETOKENIZE mode position is the index of the next token in the token array.
+
 	  \param new_pos new cursor position.
 
 	  \see get_pos()
@@ -846,11 +1832,16 @@ public:
     */
 	void set_super_script(GYS* script);
 
-	//! Copies current language definition into other script and becomes its superscript.
+	//! Shares current language definition with other script and becomes its superscript.
     /*!
+	  The definition isn't copied until one of the scripts changes it (e.g. add_gys_func()).
+	  GYS_PRETOKENIZE and GYS_COMPILE modes are inherited too.
+
 	  \param script pointer to the target script.
+	  \param thread the target script is interpreted by other thread: it gets its own copy
+	  of the definition and its calls don't share the code of GYS_source (reference counters aren't thread-safe).
     */
-	void copy_params_to_sub(GYS* script);
+	void copy_params_to_sub(GYS* script, bool thread=false);
 
 	//! Copies all the local variables into other script.
     /*!
@@ -858,6 +1849,70 @@ public:
     */
 	void copy_vars_to_script(GYS* script);
 
+	//! Prepares sub-script to interpret the code of a call (e.g. script function).
+    /*!
+	  The sub-script is created once and reused by the next calls from this script.
+	  It's reinitialized, shares the language definition and has this script as its superscript
+	  (see copy_params_to_sub()). Call end_call() when it's finished.
+	  In GYS_PRETOKENIZE mode it uses the token array of the code (see GYS_source) unless the script
+	  is interpreted by other thread (see copy_params_to_sub()).
+	  The sub-script of a small function stays bound to its code: the next call of the same code
+	  only rewinds it and keeps its variables (see GYS_OPT_INLINE).
+
+	  \param name_str sub-script's name.
+	  \param return_type type of sub-script's return value.
+	  \param code code to interpret.
+
+	  \return Pointer to the sub-script, 0 - if the previous one is still running.
+    */
+	GYS* begin_call(const string& name_str, const string& return_type, GYS_source* code);
+
+	//! Finishes the call started by begin_call() (the sub-script can be reused).
+	void end_call();
+
+	//! Adds argument of the call as new local variable (constant) without name checks.
+    /*!
+	  Unlike add_local_var() the name isn't checked: function parameters are checked once
+	  when the function is defined. The variable kept by the bound sub-script (see begin_call())
+	  just gets the new value.
+
+	  \param var_name variable's name ('@' - constant).
+	  \param val argument value.
+    */
+	void add_arg_var(const string& var_name, const GYS_ret_val& val);
+
+	//! Allows the sub-script to finish by tail calls (see set_tail_call()).
+    /*!
+	  The caller has to take the tail call by get_tail_call() after the interpretation.
+    */
+	void allow_tail_calls();
+
+	//! Checks if the tokens from the current position are the call "name(...)" ending the statement.
+    /*!
+	  It's the tail call of the function value if the statement is return (GYS_COMPILE mode only).
+
+	  \return <b>true</b> if the tail calls are allowed (see allow_tail_calls()) and enabled (GYS_OPT_TAIL_CALL).
+    */
+	bool is_tail_call();
+
+	//! Finishes the script by the tail call, the caller makes it in the same call frame.
+    /*!
+	  \param func the called function value.
+	  \param args argument values.
+
+	  \see is_tail_call(), get_tail_call()
+    */
+	void set_tail_call(const GYS_ret_val& func, const vector<GYS_ret_val>& args);
+
+	//! Takes the tail call which finished the sub-script.
+    /*!
+	  \param func gets the called function value.
+	  \param args gets the argument values.
+
+	  \return <b>false</b> if the sub-script wasn't finished by a tail call.
+    */
+	bool get_tail_call(GYS_ret_val& func, vector<GYS_ret_val>& args);
+
 	//! Reads value by evaluating the expression.
     /*!
 	  \param type_name desired type of the return value.
@@ -866,6 +1921,29 @@ public:
     */
 	GYS_ret_val get_val(string type_name);
 
+	//! Reads value of any type by evaluating the expression (without conversion).
+    /*!
+	  \param raw_type_name type of "raw" data in the expression (e.g. numbers are read as "double").
+
+	  \return Evaluation result.
+	  \see get_val()
+    */
+	GYS_ret_val get_any_val(string raw_type_name);
+
+	//! Executes the code compiled from the current position (GYS_COMPILE mode).
+    /*!
+	  Built-in function can call it to continue its own execution by the bytecode
+	  (e.g. loop at the next iteration). The code is compiled by pf once.
+
+	  \param pf compiler.
+	  \param result return value of the code.
+
+	  \return <b>true</b> if the code was executed, <b>false</b> if it can't be compiled.
+
+	  \see add_gys_func_compiler()
+    */
+	bool exec_compiled(GYS_FUNC_COMPILER_PTR pf, GYS_ret_val& result);
+
 	//! Gets variable value.
     /*!
 	  Function looks through all the local variables and if found nothing looks through global variables.
@@ -909,6 +1987,17 @@ public:
     */
 	GYS_ret_val exec_converter(GYS_ret_val val, string into_type);
 
+	//! Calls specified converter.
+    /*!
+	  \param val value to be converted.
+	  \param into_type id of desired type of new value.
+
+	  \return Convertered value.
+
+	  \see add_gys_converter()
+    */
+	GYS_ret_val exec_converter(GYS_ret_val val, GYS_type_id into_type);
+
 	//! Gets token value as string.
     /*!
 	  \return Token value.
@@ -923,6 +2012,24 @@ public:
     */
 	GYS_tok_type get_tok_type() const;
 
+	//! Gets delimeter code of the token.
+    /*!
+	  \return Delimeter code (GYS_NO_DELIM if token isn't a delimeter).
+
+	  \see get_tok_str()
+    */
+	GYS_delim get_tok_code() const;
+
+	//! Gets interned id of the token's external representation.
+    /*!
+	  Equal ids mean equal token texts within one input.
+
+	  \return Text id in GYS_PRETOKENIZE mode, -1 otherwise.
+
+	  \see get_tok_str()
+    */
+	int get_tok_id() const;
+
 	//! Gets token value as double (only if token type is GYS_DOUBLE).
     /*!
 	  \return Token double value.
@@ -965,6 +2072,8 @@ public:
 
 	//! Gets current cursor position in the input (<i>low level function</i>).
     /*!
+	  In GYS_PRETOKENIZE mode position is the index of the next token in the token array.
+
 	  \return Cursor position.
 
 	  \see set_pos()
@@ -991,6 +2100,10 @@ public:
 	bool is_pre_unary_op(string op) const;
 	bool is_post_unary_op(string op) const;
 
+	bool is_binary_op(GYS_delim code) const;
+	bool is_pre_unary_op(GYS_delim code) const;
+	bool is_post_unary_op(GYS_delim code) const;
+
 	bool is_local_var(string var_name); 
 	bool is_local_const(string var_name);
 	bool is_global_var(string var_name); 
@@ -1003,24 +2116,40 @@ public:
 	
 private:
 	void init(); // total reinit
+	GYS_language* own_lang(); // language definition for changing (copies the shared one)
 
-	GYS_ret_val exec_func();                                    // just try to process the function 
-	GYS_ret_val exec_binary_op(GYS_ret_val lval, int cur_prec); // a@...
-	GYS_ret_val exec_pre_unary_op(string ret_type);             // @...
-	GYS_ret_val exec_post_unary_op(GYS_ret_val lval);           // a@
+	GYS_tok_type lex_token(); // reads next token from the input
+	bool find_var(const string& name, unsigned long hash, GYS_var_ref& ref); // local and global variables (ref is resolved again if names were changed)
+	void add_odd_end(long pos, GYS_delim end); // remembers the current token (see move_to_odd())
+
+	GYS_ret_val exec_func();                                                      // just try to process the function 
+	GYS_ret_val exec_binary_op(GYS_ret_val lval, int cur_prec, GYS_expr_op* rec=0); // a@...
+	GYS_ret_val exec_pre_unary_op(string ret_type, GYS_expr_node** rec=0);         // @...
+	GYS_ret_val exec_post_unary_op(GYS_ret_val lval);                             // a@
 		
-	// expr anal
-	GYS_ret_val get_val(string type, int cur_prec); // with precedence for ops
-
-	GYS_ret_val get_expr_1(string type);
-	GYS_ret_val get_expr_2(string type);
-	GYS_ret_val get_expr_3(string type);
-	GYS_ret_val get_expr_4(string type);
-	GYS_ret_val get_expr_5(string type);
-	GYS_ret_val get_expr_6(string type);
-	GYS_ret_val get_expr_7(string type);
-	GYS_ret_val get_expr_8(string type);
-	GYS_ret_val get_prim(string type);
+	// expr anal (rec - where to record the expression tree)
+	GYS_ret_val get_val(string type, int cur_prec, GYS_expr_node** rec=0); // with precedence for ops
+
+	GYS_ret_val get_expr_1(string type); // uses compiled expressions in GYS_COMPILE mode
+	GYS_ret_val get_expr(int level, string type, GYS_expr_node** rec=0);
+	GYS_ret_val get_expr_loop(int level, GYS_ret_val left, GYS_expr_node** rec=0); // binary ops of this level
+	GYS_ret_val get_prim(string type, GYS_expr_node** rec=0);
+	GYS_ret_val get_prim_loop(GYS_ret_val left, GYS_expr_node* rec=0);             // postfix unary ops and []
+
+	// bytecode (gys_vm.cpp)
+	GYS_code* compile_expr(GYS_expr_node* node, const string& type);
+	GYS_ret_val exec_code(GYS_code* code);
+	GYS_ret_val exec_exit(GYS_code* code, const GYS_exit& x, GYS_vm_frame& frame); // leaves the code
+
+	// optimizer passes (gys_vm.cpp)
+	void optimize(GYS_code* code); // runs the enabled passes
+	void opt_fold(GYS_code* code);
+	void opt_branch(GYS_code* code);
+	void opt_hoist(GYS_code* code);
+	bool is_inline_code(GYS_source* code); // small body "return expr" without recursion (see GYS_OPT_INLINE)
+
+	bool lex_ahead(long p);       // lexes the token array till the index (the current token is kept)
+	bool is_tail_call_at(long p); // the tokens from the index are "name(...)" ending the statement
 
 	GYS_ret_val get_raw_val(string type_name);
 
@@ -1029,4 +2158,144 @@ private:
 	GYS_ret_val* get_global_var(string name);
 };
 
+//! Bytecode compiler (GYS_COMPILE mode).
+/*!
+  Compilers of built-in functions (see GYS::add_gys_func_compiler()) use it to emit the bytecode.
+  Positions are token indices. Only the expressions which were interpreted at least once
+  can be compiled (the bytecode is generated from their trees).
+  If the code can't do something it leaves to interpretation and the resume callbacks
+  (see push_resume()) continue the built-in function.
+*/
+class GYS_compiler
+{
+private:
+	GYS*           script;
+	GYS_code*      code;
+	GYS_token_buf* buf;
+	long           pos;        // current token index
+	int            top;        // current continuation (-1 - none)
+	int            reg_cur;    // first free register
+	long           func_pos;   // built-in function checked by the statement
+	bool           read_only;  // the value of the next compiled node is only read (see GYS_OP_VALUE)
+	vector<long>   labels;     // instruction indices
+
+	GYS_instr& emit(GYS_opcode op, long p=-1);
+	int add_exit(GYS_exit_kind kind, int reg, long p, const string& type="");
+	int push_cont(GYS_cont_kind kind);
+
+	void compile_node(GYS_expr_node* node, int level, const string& type, int dst);
+	void compile_ops(GYS_expr_node* node, const string& type, int dst);
+	void compile_prim(GYS_expr_node* node, const string& type, int dst);
+	bool compile_func(GYS_expr_node* node, const string& type, int dst); // inline
+
+	void add_block(long start, int reg); // value computed by the instructions from start
+	void finish(int reg); // END, resolves labels
+
+	friend class GYS;
+
+public:
+	//! Constructor.
+    /*!
+	  \param s script.
+	  \param target code.
+	  \param start_pos first token index.
+    */
+	GYS_compiler(GYS* s, GYS_code* target, long start_pos);
+
+	//! Gets script.
+	GYS* get_script() const;
+
+	//! Gets current token index.
+	long get_pos() const;
+
+	//! Sets current token index.
+	void set_pos(long new_pos);
+
+	//! Gets token type (GYS_EOF if token wasn't read yet).
+	GYS_tok_type get_tok_type(long p) const;
+
+	//! Gets token delimeter code.
+	GYS_delim get_tok_code(long p) const;
+
+	//! Gets token value as string.
+	string get_tok_str(long p) const;
+
+	//! Gets line number of the token.
+	long get_line_num(long p) const;
+
+	//! Finds odd end-delimeter.
+    /*!
+	  \param p first token index.
+	  \param end end-delimeter.
+	  \param end_pair pair of end-delimeter (e.g. GYS_LPAREN for GYS_RPAREN).
+
+	  \return Index of the token after odd end-delimeter, -1 if it wasn't found.
+    */
+	long find_odd(long p, GYS_delim end, GYS_delim end_pair) const;
+
+	//! Checks if the tokens from the current index are the tail call "name(...)" (see GYS::is_tail_call()).
+    /*!
+	  The statement isn't compiled then: the interpreter lets the caller make the call.
+    */
+	bool is_tail_call();
+
+	//! Allocates new register.
+	int new_reg();
+
+	//! Creates new label.
+	int new_label();
+
+	//! Places label before the next instruction.
+	void set_label(int label);
+
+	//! Gets index of the next instruction.
+	long get_code_pos() const;
+
+	//! Removes the instructions from index (e.g. when compilation of the part fails).
+	void set_code_pos(long code_pos);
+
+	//! Compiles value reading (like GYS::get_val()).
+    /*!
+	  \param type desired type.
+	  \param reg destination register.
+
+	  \return <b>true</b> if succeeded, <b>false</b> if the expression wasn't interpreted yet.
+    */
+	bool compile_val(string type, int reg);
+
+	//! Compiles one statement (like GYS::interp_next()).
+    /*!
+	  \return <b>true</b> if succeeded, <b>false</b> if the statement wasn't interpreted yet.
+    */
+	bool compile_stmt();
+
+	//! Emits jump to label.
+	void emit_jump(int label);
+
+	//! Emits jump to label if the value in reg (bool) is <b>false</b>.
+	void emit_jump_false(int reg, int label);
+
+	//! Emits jump to label if the value in reg (bool) is <b>true</b>.
+	void emit_jump_true(int reg, int label);
+
+	//! Emits leaving the code if the script is finished.
+	void emit_check_finished();
+
+	//! Emits finishing the script with value in reg.
+	void emit_return(int reg);
+
+	//! Emits leaving the code to interpretation from the token index (the token before it becomes the current one).
+	void emit_leave(long p);
+
+	//! Sets the callback which continues the built-in function when the code is left.
+    /*!
+	  Callback gets the value of the left code part (e.g. condition) and the arguments.
+	  Every push_resume() must be paired with pop_resume().
+    */
+	void push_resume(GYS_RESUME_FUNC_PTR pf, long a0=0, long a1=0, long a2=0, long a3=0, long a4=0, long a5=0);
+
+	//! Restores the previous resume callback.
+	void pop_resume();
+};
+
 #endif
\ No newline at end of file
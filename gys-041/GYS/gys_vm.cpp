@@ -0,0 +1,1896 @@
+/******************************************************************************
+ *	 GYS - library for developing interpreters of scripting languages,        *
+ *                                                                            *
+ *	 Copyright (C) 2004  Govoruschenko Yuri Y.                                *
+ *	 E-mail: ygy@users.sourceforge.net                                        *
+ *	 Web: gys.sourceforge.net                                                 *
+ *                                                                            *
+ *   This library is free software; you can redistribute it and/or            *
+ *   modify it under the terms of the GNU Lesser General Public               *
+ *   License as published by the Free Software Foundation; either             *
+ *   version 2.1 of the License, or (at your option) any later version.       *
+ *                                                                            *
+ *   This library is distributed in the hope that it will be useful,          *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU        *
+ *   Lesser General Public License for more details.                          *
+ *                                                                            *
+ *   You should have received a copy of the GNU Lesser General Public         *
+ *   License along with this library; if not, write to the Free Software      *
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA *
+ ******************************************************************************/
+
+/*! \file
+    \brief Source file for the bytecode compiler and virtual machine (GYS_COMPILE mode).
+*/
+
+// The code repeats the way the expression was interpreted (see expression trees).
+// When something differs (e.g. operator's right operand type or the token range read by callback)
+// the code is left: interpretation continues from the current token and the continuations
+// do the rest of the work (binary operators of outer levels, conversions, resume callbacks, etc).
+
+#include <iomanip>  // for setw()
+#include <algorithm> // for sort()
+
+#include "gys.h"
+
+// computed goto dispatch if the compiler supports it
+#if defined(__GNUC__)
+#define GYS_VM_GOTO
+#endif
+
+// opcode names in GYS_opcode order
+static const char* gys_opcode_names[]={
+	"LOAD_VAR", "LOAD_GLOBAL", "CALL_FUNC", "RAW", "FIND_BINARY", "BINARY", "FIND_PRE_UNARY", "PRE_UNARY",
+	"POST_UNARY", "QUICK_POST_UNARY", "CONVERT", "QUICK_BINARY", "SYNC", "CLEAR", "VALUE", "JUMP", "JUMP_FALSE", "JUMP_TRUE",
+	"FOLD", "FOLD_STORE", "HOIST", "HOIST_STORE", "CHECK_FUNC", "CHECK_VAR", "CHECK_FINISHED", "RETURN", "LEAVE", "END"
+};
+
+//--------------------------code-------------------------------
+int GYS_code::add_str(const string& str)
+{
+	for(size_t i=0; i<strs.size(); i++)
+		if(strs[i]==str)
+			return i;
+
+	strs.push_back(str);
+	str_hashes.push_back(gys_str_hash(str));
+	types.push_back(gys_void_type_id);
+	return strs.size()-1;
+}
+
+int GYS_code::add_type(const string& type)
+{
+	int i=add_str(type);
+
+	types[i]=gys_type_id(type);
+	return i;
+}
+
+void GYS_code::dump(ostream& out, const GYS_token_buf* buf) const
+{
+	long line= pos<(long)buf->toks.size() ? buf->toks[pos].line : 0;
+
+	out<<"; "<<name<<", line "<<line<<": "<<instrs.size()<<" instructions, "<<reg_num<<" registers"<<endl;
+
+	for(size_t i=0; i<instrs.size(); i++)
+	{
+		const GYS_instr& in=instrs[i];
+
+		out<<setw(5)<<i<<"  "<<setw(15)<<left<<gys_opcode_names[in.op]<<right;
+
+		switch(in.op)
+		{
+		case GYS_OP_LOAD_VAR:
+		case GYS_OP_LOAD_GLOBAL:
+			out<<"r"<<in.a<<", "<<strs[in.k];
+			break;
+		case GYS_OP_CALL_FUNC:
+			out<<"r"<<in.a<<", "<<buf->texts[buf->toks[in.pos].text]<<" @"<<in.pos<<".."<<in.end;
+			break;
+		case GYS_OP_RAW:
+			out<<"r"<<in.a<<", "<<strs[in.k]<<" @"<<in.pos<<".."<<in.end;
+			break;
+		case GYS_OP_FIND_BINARY:
+			out<<"f"<<in.c<<", r"<<in.a<<" "<<gys_delim_str((GYS_delim)in.b)<<" "<<strs[in.k];
+			break;
+		case GYS_OP_BINARY:
+			out<<"r"<<in.a<<", f"<<in.c<<"(r"<<in.a<<", r"<<in.b<<")";
+			break;
+		case GYS_OP_FIND_PRE_UNARY:
+			out<<"f"<<in.c<<", "<<gys_delim_str((GYS_delim)in.b)<<" "<<strs[in.k];
+			break;
+		case GYS_OP_PRE_UNARY:
+			out<<"r"<<in.a<<", f"<<in.c<<"(r"<<in.a<<")";
+			break;
+		case GYS_OP_POST_UNARY:
+		case GYS_OP_QUICK_POST_UNARY:
+			out<<"r"<<in.a<<", @"<<in.pos<<".."<<in.end;
+			break;
+		case GYS_OP_CONVERT:
+		case GYS_OP_QUICK_BINARY:
+			out<<"r"<<in.a<<", "<<strs[in.k];
+			break;
+		case GYS_OP_SYNC:
+		case GYS_OP_LEAVE:
+			out<<"@"<<in.pos;
+			break;
+		case GYS_OP_JUMP:
+			out<<in.k;
+			break;
+		case GYS_OP_JUMP_FALSE:
+		case GYS_OP_JUMP_TRUE:
+			out<<"r"<<in.a<<", "<<in.k;
+			break;
+		case GYS_OP_FOLD:
+			out<<"r"<<in.a<<", c"<<in.c<<", "<<folds[in.c].skip;
+			if(folds[in.c].jump>=0)
+				out<<" (branch "<<folds[in.c].jump<<")";
+			break;
+		case GYS_OP_FOLD_STORE:
+			out<<"c"<<in.c<<", r"<<in.a;
+			break;
+		case GYS_OP_HOIST:
+			out<<"r"<<in.a<<", r"<<in.b<<", "<<in.k;
+			break;
+		case GYS_OP_HOIST_STORE:
+			out<<"r"<<in.b<<", r"<<in.a;
+			break;
+		case GYS_OP_CHECK_FUNC:
+			out<<strs[in.k];
+			break;
+		case GYS_OP_CHECK_VAR:
+			out<<strs[in.k]<<", "<<strs[in.b];
+			break;
+		case GYS_OP_CLEAR:
+		case GYS_OP_VALUE:
+		case GYS_OP_RETURN:
+			out<<"r"<<in.a;
+			break;
+		case GYS_OP_END:
+			out<<"r"<<in.a<<", @"<<in.pos;
+			break;
+		default:
+			break;
+		}
+
+		out<<endl;
+	}
+}
+
+//--------------------------compiler-------------------------------
+GYS_compiler::GYS_compiler(GYS* s, GYS_code* target, long start_pos)
+	: script(s), code(target), buf(s->tok_buf), pos(start_pos), top(-1), reg_cur(0), func_pos(-1), read_only(false)
+{
+	code->expr_count=buf->expr_count;
+}
+
+GYS* GYS_compiler::get_script() const
+{
+	return script;
+}
+
+long GYS_compiler::get_pos() const
+{
+	return pos;
+}
+
+void GYS_compiler::set_pos(long new_pos)
+{
+	pos=new_pos;
+}
+
+GYS_tok_type GYS_compiler::get_tok_type(long p) const
+{
+	if(p<0 || p>=(long)buf->toks.size()) // not read yet
+		return GYS_EOF;
+
+	return buf->toks[p].type;
+}
+
+GYS_delim GYS_compiler::get_tok_code(long p) const
+{
+	if(p<0 || p>=(long)buf->toks.size())
+		return GYS_NO_DELIM;
+
+	return buf->toks[p].code;
+}
+
+string GYS_compiler::get_tok_str(long p) const
+{
+	if(p<0 || p>=(long)buf->toks.size())
+		return "";
+
+	return buf->texts[buf->toks[p].text];
+}
+
+long GYS_compiler::get_line_num(long p) const
+{
+	if(p<0 || p>=(long)buf->toks.size())
+		return 0;
+
+	return buf->toks[p].line;
+}
+
+long GYS_compiler::find_odd(long p, GYS_delim end, GYS_delim end_pair) const
+{
+	int more=1;
+
+	for(; p<(long)buf->toks.size(); p++)
+	{
+		const GYS_token& t=buf->toks[p];
+
+		if(t.type==GYS_EOF)
+			return -1;
+
+		if(t.code==end_pair)
+			more++; // we'll miss one end-delimeter
+		else if(t.code==end)
+			more--;
+
+		if(!more)
+			return p+1;
+	}
+
+	return -1; // not read yet
+}
+
+bool GYS_compiler::is_tail_call()
+{
+	if(!script->tail_calls || !script->flags.test(GYS_OPT_TAIL_CALL))
+		return false;
+
+	return script->is_tail_call_at(pos);
+}
+
+int GYS_compiler::new_reg()
+{
+	int r=reg_cur++;
+
+	if(reg_cur>code->reg_num)
+		code->reg_num=reg_cur;
+
+	return r;
+}
+
+int GYS_compiler::new_label()
+{
+	labels.push_back(-1);
+	return labels.size()-1;
+}
+
+void GYS_compiler::set_label(int label)
+{
+	labels[label]=code->instrs.size();
+}
+
+long GYS_compiler::get_code_pos() const
+{
+	return code->instrs.size();
+}
+
+void GYS_compiler::set_code_pos(long code_pos)
+{
+	code->instrs.resize(code_pos, GYS_instr(GYS_OP_END, -1));
+
+	while(!code->blocks.empty() && code->blocks.back().end>code_pos) // values of the removed instructions
+		code->blocks.pop_back();
+}
+
+void GYS_compiler::add_block(long start, int reg)
+{
+	GYS_value_block b;
+	b.start=start;
+	b.end=code->instrs.size();
+	b.reg=reg;
+
+	code->blocks.push_back(b);
+}
+
+GYS_instr& GYS_compiler::emit(GYS_opcode op, long p)
+{
+	code->instrs.push_back(GYS_instr(op, p));
+	GYS_instr& in=code->instrs.back();
+
+	switch(op) // instructions finding callbacks
+	{
+	case GYS_OP_FIND_BINARY:
+	case GYS_OP_FIND_PRE_UNARY:
+	case GYS_OP_POST_UNARY:
+	case GYS_OP_CONVERT:
+	case GYS_OP_CALL_FUNC:
+	case GYS_OP_CHECK_FUNC:
+	case GYS_OP_CHECK_VAR:
+		in.cache=code->caches.size();
+		code->caches.push_back(GYS_inline_cache());
+		break;
+	default:
+		break;
+	}
+
+	return in;
+}
+
+int GYS_compiler::add_exit(GYS_exit_kind kind, int reg, long p, const string& type)
+{
+	GYS_exit x;
+	x.kind=kind;
+	x.reg=reg;
+	x.pos=p;
+	x.type= kind==GYS_EXIT_PRIM ? code->add_type(type) : 0;
+	x.cont=top;
+	x.stale=true;
+
+	code->exits.push_back(x);
+	return code->exits.size()-1;
+}
+
+int GYS_compiler::push_cont(GYS_cont_kind kind)
+{
+	code->conts.push_back(GYS_cont(kind, top));
+	top=code->conts.size()-1;
+
+	return top;
+}
+
+void GYS_compiler::push_resume(GYS_RESUME_FUNC_PTR pf, long a0, long a1, long a2, long a3, long a4, long a5)
+{
+	GYS_cont& c=code->conts[push_cont(GYS_CONT_RESUME)];
+	c.resume=pf;
+	c.args[0]=a0;
+	c.args[1]=a1;
+	c.args[2]=a2;
+	c.args[3]=a3;
+	c.args[4]=a4;
+	c.args[5]=a5;
+}
+
+void GYS_compiler::pop_resume()
+{
+	top=code->conts[top].parent;
+}
+
+void GYS_compiler::emit_jump(int label)
+{
+	emit(GYS_OP_JUMP).k=label;
+}
+
+void GYS_compiler::emit_jump_false(int reg, int label)
+{
+	GYS_instr& in=emit(GYS_OP_JUMP_FALSE);
+	in.a=reg;
+	in.k=label;
+}
+
+void GYS_compiler::emit_jump_true(int reg, int label)
+{
+	GYS_instr& in=emit(GYS_OP_JUMP_TRUE);
+	in.a=reg;
+	in.k=label;
+}
+
+void GYS_compiler::emit_check_finished()
+{
+	int x=add_exit(GYS_EXIT_VOID, 0, -1);
+	code->exits[x].stale=false; // the code still fits
+
+	emit(GYS_OP_CHECK_FINISHED).exit=x;
+}
+
+void GYS_compiler::emit_return(int reg)
+{
+	emit(GYS_OP_RETURN).a=reg;
+}
+
+void GYS_compiler::emit_leave(long p)
+{
+	int x=add_exit(GYS_EXIT_VOID, 0, p-1);
+	emit(GYS_OP_LEAVE, p).exit=x;
+}
+
+bool GYS_compiler::compile_val(string type, int reg)
+{
+	GYS_token_buf::expr* e=buf->find_expr(pos, type);
+	if(!e) // wasn't interpreted
+		return false;
+
+	GYS_expr_node* node=e->node;
+	long start=get_code_pos();
+
+	int saved_top=top;
+	code->conts[push_cont(GYS_CONT_CONVERT)].type=code->add_type(type);
+
+	compile_node(node, 1, type, reg);
+	top=saved_top;
+
+	emit(GYS_OP_SYNC, node->end);
+
+	GYS_instr& in=emit(GYS_OP_CONVERT);
+	in.a=reg;
+	in.k=code->add_type(type);
+
+	add_block(start, reg); // converted value
+
+	pos=node->end;
+	return true;
+}
+
+bool GYS_compiler::compile_stmt()
+{
+	GYS_tok_type tok_type=get_tok_type(pos);
+	GYS_delim tok_code=get_tok_code(pos);
+	string name=get_tok_str(pos);
+	string type=gys_void_type;
+
+	bool func=false;
+
+	if(tok_type==GYS_NAME)
+	{
+		if(script->is_func(name))     // built-in func
+			func=true;
+		else if(script->is_var(name)) // local or global var
+			type=script->get_var(name)->get_type_name();
+		else
+			return false;
+	}
+	else if(tok_code==GYS_SEMICOLON)
+	{
+		pos++;
+		return true;
+	}
+	else if(tok_code!=GYS_LPAREN)
+		return false;
+
+	GYS_token_buf::expr* e=buf->find_expr(pos, type);
+	if(!e) // wasn't interpreted
+		return false;
+
+	GYS_expr_node* node=e->node;
+
+	if(tok_type==GYS_NAME) // the statement is interpreted in another way if the name changes
+	{
+		GYS_instr& in=emit(func ? GYS_OP_CHECK_FUNC : GYS_OP_CHECK_VAR, pos);
+		in.k=code->add_str(name);
+		in.exit=add_exit(GYS_EXIT_STMT, 0, pos);
+
+		if(func)
+		{
+			in.c=code->funcs.size();
+			code->funcs.push_back(script->lang->func_map.find(name)->second);
+
+			func_pos=pos;
+		}
+		else
+		{
+			in.b=code->add_type(type);
+			in.c=code->var_refs.size();
+			code->var_refs.push_back(GYS_var_ref());
+		}
+	}
+
+	int r=new_reg();
+
+	compile_node(node, 1, type, r);
+	func_pos=-1;
+
+	emit(GYS_OP_SYNC, node->end);
+	emit(GYS_OP_CLEAR).a=r; // the result isn't used
+
+	reg_cur=r;
+	pos=node->end;
+
+	return true;
+}
+
+static bool gys_pure_op(int code);
+
+// node as the expression of this level
+void GYS_compiler::compile_node(GYS_expr_node* node, int level, const string& type, int dst)
+{
+	int saved_top=top;
+	long start=get_code_pos();
+
+	// levels without operators in the tree
+	for(int l=level; l<node->level; l++)
+		code->conts[push_cont(GYS_CONT_LOOP)].level=l;
+
+	if(node->kind==GYS_EXPR_OPS)
+	{
+		read_only=false; // operators may take lvalues
+		compile_ops(node, type, dst);
+	}
+	else
+		compile_prim(node, type, dst);
+
+	add_block(start, dst);
+
+	top=saved_top;
+}
+
+void GYS_compiler::compile_ops(GYS_expr_node* node, const string& type, int dst)
+{
+	int level=node->level;
+	int saved_top=top;
+
+	code->conts[push_cont(GYS_CONT_LOOP)].level=level;
+
+	read_only=gys_pure_op(node->ops[0].code);
+	compile_node(node->sub, level+1, type, dst);
+
+	for(size_t i=0; i<node->ops.size(); i++)
+	{
+		GYS_expr_op& op=node->ops[i];
+		int f=code->op_num++;
+
+		GYS_instr& find=emit(GYS_OP_FIND_BINARY, op.pos);
+		find.a=dst;
+		find.b=op.code;
+		find.c=f;
+		find.k=code->add_type(op.r_type);
+		find.exit=add_exit(GYS_EXIT_VALUE, dst, op.pos);
+
+		// right operand
+		int r=new_reg();
+		int op_top=top;
+
+		GYS_cont& c=code->conts[push_cont(GYS_CONT_BINARY)];
+		c.reg=dst;
+		c.func=f;
+		code->conts[push_cont(GYS_CONT_CONVERT)].type=code->add_type(op.r_type);
+
+		read_only=true; // right operands are passed by value
+		compile_node(op.rval, level+1, op.r_type, r);
+		top=op_top;
+
+		emit(GYS_OP_SYNC, op.rval->end); // state before callbacks
+
+		GYS_instr& conv=emit(GYS_OP_CONVERT);
+		conv.a=r;
+		conv.b=1; // can be quickened
+		conv.k=code->add_type(op.r_type);
+
+		GYS_instr& bin=emit(GYS_OP_BINARY);
+		bin.a=dst;
+		bin.b=r;
+		bin.c=f;
+		bin.k=op.code;
+
+		reg_cur=r;
+	}
+
+	top=saved_top;
+}
+
+void GYS_compiler::compile_prim(GYS_expr_node* node, const string& type, int dst)
+{
+	int saved_top=top;
+	bool value_only=read_only;
+	read_only=false;
+
+	// trailing indices of a value which is only read don't need its lvalue
+	size_t index_from=node->ops.size();
+	while(index_from>0 && node->ops[index_from-1].code==GYS_LBRACKET)
+		index_from--;
+
+	switch(node->kind)
+	{
+	case GYS_EXPR_VAR:
+	case GYS_EXPR_GLOBAL_VAR:
+		{
+			GYS_instr& in=emit(node->kind==GYS_EXPR_VAR ? GYS_OP_LOAD_VAR : GYS_OP_LOAD_GLOBAL, node->pos);
+			in.a=dst;
+			in.b= get_tok_code(node->pos+1)==GYS_CARET; // var can become global one
+			in.k=code->add_str(node->name);
+			in.c=code->var_refs.size();
+			code->var_refs.push_back(GYS_var_ref());
+			in.exit=add_exit(GYS_EXIT_PRIM, dst, node->pos, type);
+
+			push_cont(GYS_CONT_PRIM_LOOP);
+		}
+		break;
+
+	case GYS_EXPR_FUNC: // names of functions can't become variables (add_*_var() don't allow it)
+		if(!compile_func(node, type, dst))
+		{
+			push_cont(GYS_CONT_PRIM_LOOP);
+
+			GYS_instr& in=emit(GYS_OP_CALL_FUNC, node->pos);
+			in.a=dst;
+			in.end=node->head_end;
+			in.exit=add_exit(GYS_EXIT_VALUE, dst, -1);
+		}
+		break;
+
+	case GYS_EXPR_PRE_UNARY:
+		{
+			int f=code->op_num++;
+
+			GYS_instr& find=emit(GYS_OP_FIND_PRE_UNARY, node->pos);
+			find.b=node->code;
+			find.c=f;
+			find.k=code->add_type(type);
+			find.exit=add_exit(GYS_EXIT_PRIM, dst, node->pos, type);
+
+			push_cont(GYS_CONT_PRIM_LOOP);
+			int op_top=top;
+
+			GYS_cont& c=code->conts[push_cont(GYS_CONT_PRE_UNARY)];
+			c.func=f;
+			c.code=node->code;
+			c.type=code->add_type(type);
+			code->conts[push_cont(GYS_CONT_CONVERT)].type=code->add_type(type);
+
+			compile_node(node->sub, 1, type, dst);
+			top=op_top;
+
+			emit(GYS_OP_SYNC, node->sub->end); // state before callbacks
+
+			GYS_instr& conv=emit(GYS_OP_CONVERT);
+			conv.a=dst;
+			conv.k=code->add_type(type);
+
+			GYS_instr& pre=emit(GYS_OP_PRE_UNARY);
+			pre.a=dst;
+			pre.b=node->code;
+			pre.c=f;
+			pre.k=code->add_type(type);
+		}
+		break;
+
+	case GYS_EXPR_PAREN:
+		{
+			push_cont(GYS_CONT_PRIM_LOOP);
+			int op_top=top;
+
+			push_cont(GYS_CONT_PAREN);
+			read_only= value_only && index_from==0;
+			compile_node(node->sub, 1, type, dst);
+			top=op_top;
+		}
+		break;
+
+	default: // "raw" data
+		{
+			push_cont(GYS_CONT_PRIM_LOOP);
+
+			GYS_instr& in=emit(GYS_OP_RAW, node->pos);
+			in.a=dst;
+			in.k=code->add_type(type);
+			in.end=node->head_end;
+			in.exit=add_exit(GYS_EXIT_VALUE, dst, -1);
+		}
+	}
+
+	// postfix unary ops and binary []
+	for(size_t i=0; i<node->ops.size(); i++)
+	{
+		GYS_expr_op& op=node->ops[i];
+
+		if(op.code==GYS_LBRACKET) // binary []
+		{
+			if(value_only && i==index_from)
+				emit(GYS_OP_VALUE).a=dst;
+
+			int f=code->op_num++;
+
+			GYS_instr& find=emit(GYS_OP_FIND_BINARY, op.pos);
+			find.a=dst;
+			find.b=GYS_LBRACKET;
+			find.c=f;
+			find.k=code->add_type(op.r_type);
+			find.exit=add_exit(GYS_EXIT_VALUE, dst, op.pos);
+
+			int r=new_reg();
+			int op_top=top;
+
+			push_cont(GYS_CONT_INDEX);
+			GYS_cont& c=code->conts[push_cont(GYS_CONT_BINARY)];
+			c.reg=dst;
+			c.func=f;
+			code->conts[push_cont(GYS_CONT_CONVERT)].type=code->add_type(op.r_type);
+
+			read_only=true;
+			compile_node(op.rval, 1, op.r_type, r);
+			top=op_top;
+
+			emit(GYS_OP_SYNC, op.rval->end); // state before callbacks
+
+			GYS_instr& conv=emit(GYS_OP_CONVERT);
+			conv.a=r;
+			conv.b=1; // can be quickened
+			conv.k=code->add_type(op.r_type);
+
+			GYS_instr& bin=emit(GYS_OP_BINARY);
+			bin.a=dst;
+			bin.b=r;
+			bin.c=f;
+			bin.k=GYS_LBRACKET;
+
+			reg_cur=r;
+		}
+		else // postfix unary ops
+		{
+			GYS_instr& in=emit(GYS_OP_POST_UNARY, op.pos);
+			in.a=dst;
+			in.end=op.end;
+			in.exit=add_exit(GYS_EXIT_VALUE, dst, -1);
+		}
+	}
+
+	top=saved_top;
+}
+
+// built-in function compiled by its compiler (leaves PRIM_LOOP continuation)
+bool GYS_compiler::compile_func(GYS_expr_node* node, const string& type, int dst)
+{
+	string name=get_tok_str(node->pos);
+
+	GYS::GYS_func_compiler_map::iterator compiler_iter=script->lang->func_compiler_map.find(name);
+	GYS::GYS_func_map::iterator func_iter=script->lang->func_map.find(name);
+
+	if(compiler_iter==script->lang->func_compiler_map.end() || func_iter==script->lang->func_map.end())
+		return false;
+
+	long saved_code_pos=get_code_pos();
+	long saved_pos=pos;
+	int saved_top=top;
+	int saved_reg=reg_cur;
+
+	if(func_pos!=node->pos) // not checked by the statement
+	{
+		GYS_instr& in=emit(GYS_OP_CHECK_FUNC, node->pos);
+		in.k=code->add_str(name);
+		in.c=code->funcs.size();
+		in.exit=add_exit(GYS_EXIT_PRIM, dst, node->pos, type);
+
+		code->funcs.push_back((*func_iter).second);
+	}
+
+	push_cont(GYS_CONT_PRIM_LOOP);
+	int func_top=top;
+
+	pos=node->pos+1;
+	bool ok=(*compiler_iter).second(script, this);
+
+	// the code has to end where the function ended (EOF isn't putbacked)
+	if(ok && pos!=node->head_end)
+		ok= get_tok_type(pos)==GYS_EOF && pos+1==node->head_end;
+
+	if(!ok)
+	{
+		set_code_pos(saved_code_pos);
+		top=saved_top;
+		reg_cur=saved_reg;
+		pos=saved_pos;
+
+		return false;
+	}
+
+	emit(GYS_OP_CLEAR).a=dst; // compiled functions return void
+
+	top=func_top;
+	reg_cur=saved_reg;
+	pos=saved_pos;
+
+	return true;
+}
+
+void GYS_compiler::finish(int reg)
+{
+	GYS_instr& in=emit(GYS_OP_END, pos);
+	in.a=reg;
+
+	for(size_t i=0; i<code->instrs.size(); i++)
+	{
+		GYS_instr& j=code->instrs[i];
+
+		if(j.op==GYS_OP_JUMP || j.op==GYS_OP_JUMP_FALSE || j.op==GYS_OP_JUMP_TRUE)
+			j.k=labels[j.k];
+	}
+}
+
+//--------------------------optimizer-------------------------------
+// Passes change the code after it's compiled. The values they reuse are checked every time
+// (like inline caches): if something can differ the original instructions are executed.
+
+// inserts instructions before and after the old ones
+// (jumps to the old instruction go to the ones inserted before it)
+static void gys_insert_instrs(GYS_code* code, const vector< vector<GYS_instr> >& before, const vector< vector<GYS_instr> >& after)
+{
+	size_t n=code->instrs.size();
+	vector<long> land(n+1), at(n); // new indices: of the instructions before, of the old one
+	vector<GYS_instr> instrs;
+
+	for(size_t i=0; i<=n; i++)
+	{
+		land[i]=instrs.size();
+		instrs.insert(instrs.end(), before[i].begin(), before[i].end());
+
+		if(i==n)
+			break;
+
+		at[i]=instrs.size();
+		instrs.push_back(code->instrs[i]);
+		instrs.insert(instrs.end(), after[i].begin(), after[i].end());
+	}
+
+	for(size_t i=0; i<instrs.size(); i++)
+	{
+		GYS_instr& in=instrs[i];
+
+		if(in.op==GYS_OP_JUMP || in.op==GYS_OP_JUMP_FALSE || in.op==GYS_OP_JUMP_TRUE || in.op==GYS_OP_HOIST)
+			in.k=land[in.k];
+	}
+
+	for(size_t i=0; i<code->folds.size(); i++)
+	{
+		GYS_fold& fold=code->folds[i];
+
+		fold.skip=land[fold.skip];
+		if(fold.jump>=0)
+			fold.jump=at[fold.jump];
+	}
+
+	code->instrs.swap(instrs);
+}
+
+// outer blocks first
+static bool gys_block_less(const GYS_value_block& a, const GYS_value_block& b)
+{
+	return a.start<b.start || (a.start==b.start && a.end>b.end);
+}
+
+// operators which don't change their operands
+static bool gys_pure_op(int code)
+{
+	switch(code)
+	{
+	case GYS_LBRACKET: case GYS_LESS: case GYS_GREATER: case GYS_PLUS: case GYS_MINUS: case GYS_MUL:
+	case GYS_BIT_AND: case GYS_BIT_OR: case GYS_MOD: case GYS_CARET: case GYS_DIV: case GYS_EQUAL:
+	case GYS_NOT_EQUAL: case GYS_IDENT: case GYS_NOT_IDENT: case GYS_LESS_EQ: case GYS_GREATER_EQ:
+	case GYS_SHL: case GYS_SHR: case GYS_AND: case GYS_OR:
+		return true;
+	default:
+		return false;
+	}
+}
+
+// delimeters which change the variable near them
+static bool gys_changing_delim(GYS_delim code)
+{
+	switch(code)
+	{
+	case GYS_ASSIGN: case GYS_DEF_ASSIGN: case GYS_PLUS_ASSIGN: case GYS_MINUS_ASSIGN: case GYS_MUL_ASSIGN:
+	case GYS_DIV_ASSIGN: case GYS_MOD_ASSIGN: case GYS_SHL_ASSIGN: case GYS_SHR_ASSIGN: case GYS_INC: case GYS_DEC:
+		return true;
+	default:
+		return false;
+	}
+}
+
+void GYS::optimize(GYS_code* code)
+{
+	// passes in their order
+	static const struct
+	{
+		GYS_flag flag;
+		void (GYS::*run)(GYS_code*);
+	} passes[]={
+		{ GYS_OPT_FOLD,   &GYS::opt_fold   },
+		{ GYS_OPT_BRANCH, &GYS::opt_branch },
+		{ GYS_OPT_HOIST,  &GYS::opt_hoist  }
+	};
+
+	for(size_t i=0; i<sizeof(passes)/sizeof(passes[0]); i++)
+		if(flags.test(passes[i].flag))
+			(this->*passes[i].run)(code);
+
+	code->blocks.clear();
+}
+
+// values of constant expressions (literals, constants and operators) are computed once:
+// FOLD c, the instructions, FOLD_STORE c
+void GYS::opt_fold(GYS_code* code)
+{
+	size_t n=code->instrs.size();
+	vector< vector<GYS_instr> > before(n+1), after(n);
+
+	vector<GYS_value_block> blocks=code->blocks;
+	sort(blocks.begin(), blocks.end(), gys_block_less);
+
+	long folded=0; // end of the last folded block
+
+	for(size_t i=0; i<blocks.size(); i++)
+	{
+		const GYS_value_block& b=blocks[i];
+
+		if(b.start<folded) // inside the folded one
+			continue;
+
+		bool ok=true, raw=false;
+		vector<int> vars;
+
+		for(long j=b.start; j<b.end && ok; j++)
+		{
+			const GYS_instr& in=code->instrs[j];
+
+			switch(in.op)
+			{
+			case GYS_OP_LOAD_VAR:
+				ok= !in.b && is_const(code->strs[in.k]);
+				vars.push_back(in.c);
+				break;
+			case GYS_OP_RAW: // literal
+				{
+					GYS_tok_type type=tok_buf->toks[in.pos].type;
+					ok= in.end==in.pos+1 && (type==GYS_DOUBLE || type==GYS_STRING || type==GYS_CHAR);
+					raw=true;
+				}
+				break;
+			case GYS_OP_FIND_BINARY:
+				ok=gys_pure_op(in.b);
+				break;
+			case GYS_OP_FIND_PRE_UNARY:
+				ok= in.b!=GYS_INC && in.b!=GYS_DEC;
+				break;
+			case GYS_OP_BINARY:
+			case GYS_OP_PRE_UNARY:
+			case GYS_OP_CONVERT:
+			case GYS_OP_SYNC:
+			case GYS_OP_VALUE:
+				break;
+			default:
+				ok=false;
+			}
+		}
+
+		if(!ok || (!raw && b.end-b.start<2)) // loading of the constant is fast enough
+			continue;
+
+		GYS_fold fold;
+		fold.vars=vars;
+		fold.skip=b.end;
+		code->folds.push_back(fold);
+
+		GYS_instr in(GYS_OP_FOLD, -1);
+		in.a=b.reg;
+		in.c=code->folds.size()-1;
+		before[b.start].push_back(in);
+
+		in.op=GYS_OP_FOLD_STORE;
+		after[b.end-1].push_back(in);
+
+		folded=b.end;
+	}
+
+	if(!code->folds.empty())
+		gys_insert_instrs(code, before, after);
+}
+
+// conditional jump on the folded value goes from FOLD at once
+void GYS::opt_branch(GYS_code* code)
+{
+	for(size_t i=0; i+1<code->instrs.size(); i++)
+	{
+		const GYS_instr& in=code->instrs[i];
+		const GYS_instr& next=code->instrs[i+1];
+
+		if(in.op==GYS_OP_FOLD_STORE && (next.op==GYS_OP_JUMP_FALSE || next.op==GYS_OP_JUMP_TRUE) && next.a==in.a)
+			code->folds[in.c].jump=i+1;
+	}
+}
+
+// the values of the variables and their elements aren't shared with other variables
+// (e.g. "vector w=v", "vector inner=v[0]"), so they're changed only by the names which are checked by opt_hoist()
+static bool gys_unshared_vars(const vector<GYS_ret_val*>& vars)
+{
+	for(size_t i=0; i<vars.size(); i++)
+	{
+		GYS_user_val* v=vars[i]->get_ptr_to_user_val();
+
+		if(v && (v->getRefCnt()>1 || v->shares_values()))
+			return false;
+	}
+
+	return true;
+}
+
+// the built-in function is pure (see add_pure_gys_func())
+static bool gys_is_pure_func(GYS_language* lang, const string& name)
+{
+	GYS_language::GYS_pure_func_map::iterator pure_iter=lang->pure_func_map.find(name);
+	GYS_language::GYS_func_map::iterator func_iter=lang->func_map.find(name);
+
+	return pure_iter!=lang->pure_func_map.end() && func_iter!=lang->func_map.end() && (*pure_iter).second==(*func_iter).second;
+}
+
+// calls of pure functions with local variables which the code doesn't change are done once per run:
+// HOIST, CALL_FUNC, HOIST_STORE (the value is kept in a new register)
+void GYS::opt_hoist(GYS_code* code)
+{
+	size_t n=code->instrs.size();
+	vector< vector<GYS_instr> > before(n+1), after(n);
+
+	const vector<GYS_token>& toks=tok_buf->toks;
+	long end=code->instrs.back().pos; // tokens of the code
+
+	// token ranges of the calls
+	vector<long> pure_calls, other_calls; // pairs of positions
+
+	for(size_t i=0; i<n; i++)
+	{
+		const GYS_instr& in=code->instrs[i];
+
+		if(in.op==GYS_OP_CALL_FUNC || in.op==GYS_OP_RAW)
+		{
+			vector<long>& calls= in.op==GYS_OP_CALL_FUNC && gys_is_pure_func(lang, tok_buf->texts[toks[in.pos].text]) ? pure_calls : other_calls;
+			calls.push_back(in.pos);
+			calls.push_back(in.end);
+		}
+	}
+
+	for(size_t i=0; i<n; i++)
+	{
+		const GYS_instr& in=code->instrs[i];
+
+		if(in.op!=GYS_OP_CALL_FUNC || !gys_is_pure_func(lang, tok_buf->texts[toks[in.pos].text]))
+			continue;
+
+		bool ok=true;
+		vector<int> vars;
+
+		for(long p=in.pos+1; p<in.end && ok; p++) // arguments
+		{
+			const GYS_token& t=toks[p];
+			const string& name=tok_buf->texts[t.text];
+
+			if(t.type==GYS_DELIMETER)
+				ok=!gys_changing_delim(t.code);
+			else if(t.type==GYS_NAME)
+			{
+				if(gys_is_pure_func(lang, name))
+					continue;
+
+				if(!is_local_var(name))
+				{
+					ok=false;
+					break;
+				}
+
+				vars.push_back(code->add_str(name));
+
+				// the variable mustn't change in the code
+				for(long q=code->pos; q<end && ok; q++)
+				{
+					if(toks[q].type!=GYS_NAME || tok_buf->texts[toks[q].text]!=name)
+						continue;
+
+					size_t c;
+
+					for(c=0; c<pure_calls.size(); c+=2)
+						if(q>pure_calls[c] && q<pure_calls[c+1])
+							break;
+					if(c<pure_calls.size()) // argument of pure function
+						continue;
+
+					for(c=0; c<other_calls.size(); c+=2)
+						if(q>=other_calls[c] && q<other_calls[c+1])
+							ok=false;
+
+					if(q>code->pos && (toks[q-1].type==GYS_NAME || gys_changing_delim(toks[q-1].code))) // declaration, ++var
+						ok=false;
+
+					long r=q+1;
+					while(r<end && toks[r].code==GYS_LBRACKET) // indices
+					{
+						int more=1;
+						for(r++; r<end && more; r++)
+						{
+							if(toks[r].code==GYS_LBRACKET)
+								more++;
+							else if(toks[r].code==GYS_RBRACKET)
+								more--;
+						}
+					}
+
+					if(r<end && (gys_changing_delim(toks[r].code) || toks[r].code==GYS_CARET)) // var=, var++, var^
+						ok=false;
+				}
+			}
+			else if(t.type!=GYS_DOUBLE && t.type!=GYS_STRING && t.type!=GYS_CHAR)
+				ok=false;
+		}
+
+		if(!ok)
+			continue;
+
+		GYS_hoist hoist;
+		hoist.func=lang->func_map.find(tok_buf->texts[toks[in.pos].text])->second;
+		hoist.vars=vars;
+		code->hoists.push_back(hoist);
+
+		GYS_instr h(GYS_OP_HOIST, -1);
+		h.a=in.a;
+		h.b=code->reg_num++; // hoisted value
+		h.c=code->hoists.size()-1;
+		h.k=i+1;
+		before[i].push_back(h);
+
+		h.op=GYS_OP_HOIST_STORE;
+		after[i].push_back(h);
+	}
+
+	if(!code->hoists.empty())
+		gys_insert_instrs(code, before, after);
+}
+
+// function body "return expr" is small enough and doesn't call itself, its calls can stay bound
+// to the sub-script (see GYS::begin_call()): the result is rechecked when the language changes
+bool GYS::is_inline_code(GYS_source* code)
+{
+	if(code->inline_gen==lang->gen)
+		return code->inlined;
+
+	GYS_token_buf* buf=code->tok_buf;
+
+	// the statement has to be compiled
+	GYS_code* stmt=0;
+
+	if(buf && buf->complete && !buf->exprs.empty())
+		for(size_t i=0; i<buf->exprs[0].size(); i++)
+			if(buf->exprs[0][i].code && !buf->exprs[0][i].code->stale)
+				stmt=buf->exprs[0][i].code;
+
+	if(!stmt) // not yet
+		return false;
+
+	code->inline_gen=lang->gen;
+	code->inlined=false;
+
+	const vector<GYS_token>& toks=buf->toks;
+
+	if(toks.size()<3 || toks[0].type!=GYS_NAME || buf->texts[toks[0].text]!="return")
+		return false;
+
+	if(stmt->instrs.size()>(size_t)gys_max_inline_instrs)
+		return false;
+
+	size_t end=toks.size()-1; // EOF
+	if(toks[end-1].code==GYS_SEMICOLON)
+		end--;
+
+	for(size_t i=1; i<end; i++)
+	{
+		const GYS_token& t=toks[i];
+		const string& name=buf->texts[t.text];
+
+		if(t.code==GYS_SEMICOLON || t.code==GYS_LBRACE || t.code==GYS_RBRACE) // not the only statement
+			return false;
+
+		if(t.type==GYS_NAME || t.type==GYS_CONST)
+		{
+			if(name=="SELF" || name=="@SELF") // recursion
+				return false;
+
+			if(toks[i+1].type==GYS_NAME || toks[i+1].type==GYS_CONST) // new variable
+				return false;
+
+			if(is_func(name) && !is_typename(name) && !gys_is_pure_func(lang, name)) // it can change the sub-script
+				return false;
+		}
+	}
+
+	code->inlined=true;
+	return true;
+}
+
+//--------------------------interpreter-------------------------------
+GYS_code* GYS::compile_expr(GYS_expr_node* node, const string& type)
+{
+	GYS_code* code=new GYS_code(node->pos, "expression ("+type+")");
+
+	GYS_compiler c(this, code, node->pos);
+
+	int r=c.new_reg();
+	c.compile_node(node, 1, type, r);
+
+	c.set_pos(node->end);
+	c.finish(r);
+
+	optimize(code);
+
+	if(flags.test(GYS_DUMP_BYTECODE))
+		code->dump(clog, tok_buf);
+
+	return code;
+}
+
+bool GYS::exec_compiled(GYS_FUNC_COMPILER_PTR pf, GYS_ret_val& result)
+{
+	if(!flags.test(GYS_COMPILE) || !tok_buf)
+		return false;
+
+	RefCntPointer<GYS_token_buf> buf=tok_buf; // keep the code alive
+	long pos=tok_pos;
+
+	GYS_token_buf::func_code& fc=buf->get_func_code(pos, pf);
+
+	// the code which was left can be compiled better when new trees appear
+	if( (!fc.code && fc.fail_count!=buf->expr_count) ||
+		(fc.code && fc.code->stale && fc.code->expr_count!=buf->expr_count && fc.versions<gys_max_code_versions) )
+	{
+		GYS_code* code=new GYS_code(pos, "built-in function code after '"+buf->texts[buf->toks[pos-1].text]+"'");
+		RefCntPointer<GYS_code> keep=code;
+
+		GYS_compiler c(this, code, pos);
+
+		int r=c.new_reg(); // void
+		if(pf(this, &c))
+		{
+			c.finish(r);
+
+			optimize(code);
+
+			if(flags.test(GYS_DUMP_BYTECODE))
+				code->dump(clog, buf);
+
+			fc.code=code;
+			fc.versions++;
+		}
+		else // some code wasn't interpreted yet
+			fc.fail_count=buf->expr_count;
+	}
+
+	if(!fc.code)
+		return false;
+
+	// the interpreter continues the loop which was left by this code
+	// (otherwise every exit would nest one more execution)
+	if(fc.code->stale && fc.code->running)
+		return false;
+
+	RefCntPointer<GYS_code> code=fc.code; // callbacks can compile other functions
+
+	result.clean(); // not lvalue
+	result=exec_code(code);
+
+	return true;
+}
+
+// runs the code from the first instruction
+GYS_ret_val GYS::exec_code(GYS_code* code)
+{
+	if(vm_depth==(int)vm_frames.size()) // deque doesn't move other frames
+		vm_frames.push_back(GYS_vm_frame());
+
+	GYS_vm_frame& frame=vm_frames[vm_depth++];
+	code->running++;
+
+	if((int)frame.regs.size()<code->reg_num)
+		frame.regs.resize(code->reg_num);
+	if((int)frame.ops.size()<code->op_num)
+		frame.ops.resize(code->op_num);
+	if(frame.hoists.size()<code->hoists.size())
+		frame.hoists.resize(code->hoists.size());
+
+	GYS_ret_val* r= frame.regs.empty() ? 0 : &frame.regs[0];
+	GYS_vm_frame::op_func* f= frame.ops.empty() ? 0 : &frame.ops[0];
+
+	const GYS_instr* start=&code->instrs[0];
+	const GYS_instr* ip=start;
+
+	GYS_ret_val result;
+
+#ifdef GYS_VM_GOTO
+	// labels in GYS_opcode order
+	static void* labels[]={
+		&&L_GYS_OP_LOAD_VAR, &&L_GYS_OP_LOAD_GLOBAL, &&L_GYS_OP_CALL_FUNC, &&L_GYS_OP_RAW,
+		&&L_GYS_OP_FIND_BINARY, &&L_GYS_OP_BINARY, &&L_GYS_OP_FIND_PRE_UNARY, &&L_GYS_OP_PRE_UNARY,
+		&&L_GYS_OP_POST_UNARY, &&L_GYS_OP_QUICK_POST_UNARY, &&L_GYS_OP_CONVERT, &&L_GYS_OP_QUICK_BINARY,
+		&&L_GYS_OP_SYNC, &&L_GYS_OP_CLEAR, &&L_GYS_OP_VALUE,
+		&&L_GYS_OP_JUMP, &&L_GYS_OP_JUMP_FALSE, &&L_GYS_OP_JUMP_TRUE,
+		&&L_GYS_OP_FOLD, &&L_GYS_OP_FOLD_STORE, &&L_GYS_OP_HOIST, &&L_GYS_OP_HOIST_STORE,
+		&&L_GYS_OP_CHECK_FUNC, &&L_GYS_OP_CHECK_VAR, &&L_GYS_OP_CHECK_FINISHED, &&L_GYS_OP_RETURN, &&L_GYS_OP_LEAVE,
+		&&L_GYS_OP_END
+	};
+
+#define VM_CASE(op) L_##op:
+#define VM_DISPATCH goto *labels[ip->op]
+#else
+#define VM_CASE(op) case op:
+#define VM_DISPATCH continue
+#endif
+
+#define VM_NEXT  { ip++; VM_DISPATCH; }
+#define VM_LEAVE goto leave
+
+#ifdef GYS_VM_GOTO
+	VM_DISPATCH;
+#else
+	for(;;) switch(ip->op)
+	{
+#endif
+
+	VM_CASE(GYS_OP_LOAD_VAR)
+	{
+		GYS_var_ref& var=code->var_refs[ip->c];
+
+		if( (ip->b && flags.test(GYS_GLOBAL_VAR_OP)) || !find_var(code->strs[ip->k], code->str_hashes[ip->k], var) ) // not the same
+			VM_LEAVE;
+
+		line_num=tok_buf->toks[ip->pos+1].line;
+
+		r[ip->a].clean(); // not lvalue
+		if(var.is_const())
+			r[ip->a]=var.cell()->first; // not lvalue
+		else
+			r[ip->a]=&var.cell()->first;
+	}
+	VM_NEXT;
+
+	VM_CASE(GYS_OP_LOAD_GLOBAL)
+	{
+		GYS_var_ref& var=code->var_refs[ip->c];
+
+		if(!flags.test(GYS_GLOBAL_VAR_OP) || !find_var(code->strs[ip->k], code->str_hashes[ip->k], var)) // not the same
+			VM_LEAVE;
+
+		line_num=tok_buf->toks[ip->pos+1].line;
+
+		r[ip->a].clean(); // not lvalue
+		if(!var.global)
+			error("Unknown global variable: ", code->strs[ip->k]);
+		else if(var.global->second) // is const
+			r[ip->a]=var.global->first; // not lvalue
+		else
+			r[ip->a]=&var.global->first;
+	}
+	VM_NEXT;
+
+	VM_CASE(GYS_OP_CALL_FUNC)
+	{
+		set_pos(ip->pos);
+		get_token();
+
+		GYS_inline_cache& ic=code->caches[ip->cache];
+
+		if(ic.gen!=lang->gen) // the definition was changed
+		{
+			GYS_func_map::iterator func_iter=lang->func_map.find(token, tok_hash);
+
+			ic.gen= func_iter!=lang->func_map.end() ? (unsigned long)lang->gen : 0;
+			ic.func= ic.gen ? (*func_iter).second : 0;
+		}
+
+		GYS_ret_val t= ic.func ? ic.func(this) : exec_func(); // exec_func() reports the error
+		r[ip->a].clean(); // not lvalue
+		r[ip->a]=t;
+
+		if(tok_pos!=ip->end) // function read another code
+			VM_LEAVE;
+	}
+	VM_NEXT;
+
+	VM_CASE(GYS_OP_RAW)
+	{
+		set_pos(ip->pos);
+		get_token();
+		putback_tok();
+
+		GYS_ret_val t=get_raw_val(code->strs[ip->k]);
+		r[ip->a].clean(); // not lvalue
+		r[ip->a]=t;
+
+		if(tok_pos!=ip->end) // type func read another code
+			VM_LEAVE;
+	}
+	VM_NEXT;
+
+	VM_CASE(GYS_OP_FIND_BINARY)
+	{
+		GYS_inline_cache& ic=code->caches[ip->cache];
+		GYS_type_id type=r[ip->a].get_type_id();
+
+		if(ic.gen!=lang->gen || ic.type!=type) // miss
+		{
+			GYS_binary_op op=lang->binary_op_table.get(ip->b, type);
+
+			if(!op.func || op.r_type!=code->types[ip->k]) // another operator
+				VM_LEAVE;
+
+			ic.gen=lang->gen;
+			ic.type=type;
+			ic.binary=op.func;
+		}
+
+		f[ip->c].binary=ic.binary;
+	}
+	VM_NEXT;
+
+	VM_CASE(GYS_OP_BINARY)
+	{
+		GYS_ret_val t=f[ip->c].binary(this, r[ip->a], r[ip->b]); // processing operator
+		r[ip->a].clean(); // not lvalue
+		r[ip->a]=t;
+	}
+	VM_NEXT;
+
+	VM_CASE(GYS_OP_FIND_PRE_UNARY)
+	{
+		GYS_inline_cache& ic=code->caches[ip->cache];
+
+		if(ic.gen!=lang->gen) // miss
+		{
+			GYS_PRE_UNARY_OP_FUNC_PTR pf=lang->pre_unary_op_table.get(ip->b, code->types[ip->k]);
+
+			if(!pf) // not the same
+				VM_LEAVE;
+
+			ic.gen=lang->gen;
+			ic.pre_unary=pf;
+		}
+
+		f[ip->c].pre_unary=ic.pre_unary;
+	}
+	VM_NEXT;
+
+	VM_CASE(GYS_OP_PRE_UNARY)
+	{
+		GYS_ret_val t=f[ip->c].pre_unary(this, r[ip->a]); // processing operator
+		r[ip->a].clean(); // not lvalue
+
+		if(t.get_type_id()==code->types[ip->k]) // ok
+			r[ip->a]=t;
+		else                                     // error
+			error("Prefix unary operator '"+string(gys_delim_str((GYS_delim)ip->b))+"' doesn't return '"+code->strs[ip->k]+"' : ", t.get_type_name());
+	}
+	VM_NEXT;
+
+	VM_CASE(GYS_OP_POST_UNARY)
+	{
+		GYS_inline_cache& ic=code->caches[ip->cache];
+		GYS_type_id type=r[ip->a].get_type_id();
+
+		if(ic.gen!=lang->gen || ic.type!=type) // quick form wasn't checked for the type
+		{
+			ic.gen=lang->gen;
+			ic.type=type;
+			ic.post_unary=lang->quick_post_unary_op_table.get(tok_buf->toks[ip->pos].code, type);
+
+			if(ic.post_unary) // quickening
+			{
+				code->instrs[ip-start].op=GYS_OP_QUICK_POST_UNARY;
+				VM_DISPATCH;
+			}
+		}
+
+		set_pos(ip->pos);
+		get_token();
+
+		GYS_ret_val t=exec_post_unary_op(r[ip->a]);
+		r[ip->a].clean(); // not lvalue
+		r[ip->a]=t;
+
+		if(tok_pos!=ip->end) // callback read another code
+			VM_LEAVE;
+	}
+	VM_NEXT;
+
+	VM_CASE(GYS_OP_QUICK_POST_UNARY)
+	{
+		GYS_inline_cache& ic=code->caches[ip->cache];
+
+		if(ic.gen!=lang->gen || ic.type!=r[ip->a].get_type_id()) // deoptimization
+		{
+			code->instrs[ip-start].op=GYS_OP_POST_UNARY;
+			VM_DISPATCH;
+		}
+
+		line_num=tok_buf->toks[ip->pos].line; // for errors
+
+		GYS_ret_val t=ic.post_unary(this, r[ip->a]);
+		r[ip->a].clean(); // not lvalue
+		r[ip->a]=t;
+	}
+	VM_NEXT;
+
+	VM_CASE(GYS_OP_CONVERT)
+	{
+		GYS_type_id type=r[ip->a].get_type_id();
+
+		if(type!=code->types[ip->k])
+		{
+			GYS_inline_cache& ic=code->caches[ip->cache];
+
+			if(ic.gen!=lang->gen || ic.type!=type) // miss
+			{
+				if(ip->b) // right operand of the next BINARY
+				{
+					const vector<GYS_language::GYS_quick_binary_op_table>& quick=lang->quick_binary_op_tables;
+					GYS_type_id l_type=r[ip[1].a].get_type_id();
+
+					if(ip[1].k<(int)quick.size())
+						if(GYS_BINARY_OP_FUNC_PTR pf=quick[ip[1].k].get(l_type, type)) // quickening
+						{
+							ic.gen=lang->gen;
+							ic.type=l_type;
+							ic.r_type=type;
+							ic.binary=pf;
+
+							code->instrs[ip-start].op=GYS_OP_QUICK_BINARY;
+							VM_DISPATCH;
+						}
+				}
+
+				ic.converter=lang->converter_table.get(type, code->types[ip->k]);
+				ic.gen= ic.converter ? (unsigned long)lang->gen : 0;
+				ic.type=type;
+			}
+
+			GYS_ret_val t= ic.converter ? ic.converter(this, r[ip->a]) : exec_converter(r[ip->a], code->types[ip->k]); // exec_converter() reports the error
+			r[ip->a].clean(); // not lvalue
+			r[ip->a]=t;
+		}
+	}
+	VM_NEXT;
+
+	VM_CASE(GYS_OP_QUICK_BINARY)
+	{
+		GYS_inline_cache& ic=code->caches[ip->cache];
+		const GYS_instr& bin=ip[1];
+
+		if(ic.gen!=lang->gen || ic.r_type!=r[ip->a].get_type_id() || ic.type!=r[bin.a].get_type_id()) // deoptimization
+		{
+			ic.gen=0;
+			code->instrs[ip-start].op=GYS_OP_CONVERT;
+			VM_DISPATCH;
+		}
+
+		GYS_ret_val t=ic.binary(this, r[bin.a], r[ip->a]); // without conversion
+		r[bin.a].clean(); // not lvalue
+		r[bin.a]=t;
+
+		ip+=2; // BINARY is done
+	}
+	VM_DISPATCH;
+
+	VM_CASE(GYS_OP_SYNC)
+	{
+		set_pos(ip->pos);
+		get_token();
+		putback_tok();
+	}
+	VM_NEXT;
+
+	VM_CASE(GYS_OP_CLEAR)
+	{
+		r[ip->a].clean();
+	}
+	VM_NEXT;
+
+	VM_CASE(GYS_OP_VALUE)
+	{
+		if(r[ip->a].is_lvalue())
+		{
+			GYS_ret_val v=r[ip->a].get_value();
+			r[ip->a].clean(); // not lvalue
+			r[ip->a]=v;
+		}
+	}
+	VM_NEXT;
+
+	VM_CASE(GYS_OP_JUMP)
+	{
+		ip=start+ip->k;
+	}
+	VM_DISPATCH;
+
+	VM_CASE(GYS_OP_JUMP_FALSE)
+	{
+		bool yes=r[ip->a];
+
+		if(!yes)
+		{
+			ip=start+ip->k;
+			VM_DISPATCH;
+		}
+	}
+	VM_NEXT;
+
+	VM_CASE(GYS_OP_JUMP_TRUE)
+	{
+		bool yes=r[ip->a];
+
+		if(yes)
+		{
+			ip=start+ip->k;
+			VM_DISPATCH;
+		}
+	}
+	VM_NEXT;
+
+	VM_CASE(GYS_OP_FOLD)
+	{
+		GYS_fold& fold=code->folds[ip->c];
+
+		if(fold.gen==lang->gen && (fold.vars.empty() || (fold.var_gen==var_gen && fold.global_gen==global_var_gen))) // the same value
+		{
+			r[ip->a].clean(); // not lvalue
+			r[ip->a]=fold.val;
+
+			ip=start+fold.target;
+			VM_DISPATCH;
+		}
+
+		fold.reports=error_num+warning_num;
+	}
+	VM_NEXT;
+
+	VM_CASE(GYS_OP_FOLD_STORE)
+	{
+		GYS_fold& fold=code->folds[ip->c];
+		bool consts= fold.reports==error_num+warning_num; // the value is the same every time
+
+		for(size_t i=0; i<fold.vars.size(); i++)
+			if(!code->var_refs[fold.vars[i]].is_const())
+				consts=false;
+
+		if(consts)
+		{
+			fold.val=r[ip->a].get_value();
+			fold.gen=lang->gen;
+			fold.var_gen=var_gen;
+			fold.global_gen=global_var_gen;
+			fold.target=fold.skip;
+
+			if(fold.jump>=0) // the branch is known
+			{
+				const GYS_instr& jump=code->instrs[fold.jump];
+				bool yes=fold.val;
+
+				fold.target= yes==(jump.op==GYS_OP_JUMP_TRUE) ? jump.k : fold.jump+1;
+			}
+		}
+	}
+	VM_NEXT;
+
+	VM_CASE(GYS_OP_HOIST)
+	{
+		GYS_vm_frame::hoisted& h=frame.hoists[ip->c];
+
+		if(r[ip->b].get_type_id()!=gys_void_type_id && h.gen==lang->gen && h.var_gen==var_gen && gys_unshared_vars(h.vars)) // computed by this run
+		{
+			r[ip->a].clean(); // not lvalue
+			r[ip->a]=r[ip->b];
+
+			set_pos(ip[1].end); // as if the function was called
+			ip=start+ip->k;
+			VM_DISPATCH;
+		}
+
+		h.reports=error_num+warning_num;
+	}
+	VM_NEXT;
+
+	VM_CASE(GYS_OP_HOIST_STORE)
+	{
+		GYS_vm_frame::hoisted& h=frame.hoists[ip->c];
+		const GYS_hoist& hoist=code->hoists[ip->c];
+		const GYS_inline_cache& ic=code->caches[ip[-1].cache]; // of the call
+
+		bool pure= h.reports==error_num+warning_num && ic.gen==lang->gen && ic.func==hoist.func;
+
+		h.vars.clear();
+
+		for(size_t i=0; i<hoist.vars.size() && pure; i++) // arguments are still local
+		{
+			GYS_var_map::iterator var_iter=var_map.find(code->strs[hoist.vars[i]], code->str_hashes[hoist.vars[i]]);
+
+			if(var_iter==var_map.end())
+				pure=false;
+			else
+				h.vars.push_back(&(*var_iter).second.first);
+		}
+
+		if(pure)
+		{
+			r[ip->b].clean();
+			r[ip->b]=r[ip->a].get_value();
+
+			h.gen=lang->gen;
+			h.var_gen=var_gen;
+		}
+	}
+	VM_NEXT;
+
+	VM_CASE(GYS_OP_CHECK_FUNC)
+	{
+		GYS_inline_cache& ic=code->caches[ip->cache];
+
+		if(ic.gen!=lang->gen) // the definition was changed
+		{
+			GYS_func_map::iterator func_iter=lang->func_map.find(code->strs[ip->k], code->str_hashes[ip->k]);
+
+			if(func_iter==lang->func_map.end() || (*func_iter).second!=code->funcs[ip->c]) // not the same
+				VM_LEAVE;
+
+			ic.gen=lang->gen;
+		}
+	}
+	VM_NEXT;
+
+	VM_CASE(GYS_OP_CHECK_VAR)
+	{
+		const string& vname=code->strs[ip->k];
+		GYS_var_ref& var=code->var_refs[ip->c];
+
+		unsigned long hash=code->str_hashes[ip->k];
+		GYS_inline_cache& ic=code->caches[ip->cache];
+
+		if(ic.gen!=lang->gen) // the definition was changed
+		{
+			if(lang->func_map.find(vname, hash)!=lang->func_map.end()) // became function
+				VM_LEAVE;
+
+			ic.gen=lang->gen;
+		}
+
+		if(!find_var(vname, hash, var) || var.cell()->first.get_type_id()!=code->types[ip->b]) // not the same
+			VM_LEAVE;
+	}
+	VM_NEXT;
+
+	VM_CASE(GYS_OP_CHECK_FINISHED)
+	{
+		if(was_finished) // e.g. after return
+			VM_LEAVE;
+	}
+	VM_NEXT;
+
+	VM_CASE(GYS_OP_RETURN)
+	{
+		set_ret_val(r[ip->a].get_value());
+		finish_script();
+	}
+	VM_NEXT;
+
+	VM_CASE(GYS_OP_LEAVE)
+	{
+		VM_LEAVE;
+	}
+
+	VM_CASE(GYS_OP_END)
+	{
+		// the token after the code is the current one
+		set_pos(ip->pos);
+		get_token();
+		putback_tok();
+
+		result=r[ip->a];
+		goto done;
+	}
+
+#ifndef GYS_VM_GOTO
+	}
+#endif
+
+#undef VM_CASE
+#undef VM_DISPATCH
+#undef VM_NEXT
+#undef VM_LEAVE
+
+leave:
+	result=exec_exit(code, code->exits[ip->exit], frame);
+
+done:
+	for(int i=0; i<code->reg_num; i++)
+		r[i].clean();
+
+	code->running--;
+	vm_depth--;
+
+	return result;
+}
+
+// interpretation continues from the exit
+GYS_ret_val GYS::exec_exit(GYS_code* code, const GYS_exit& x, GYS_vm_frame& frame)
+{
+	if(x.stale) // the code doesn't fit anymore
+		code->stale=true;
+
+	GYS_ret_val v;
+
+	switch(x.kind)
+	{
+	case GYS_EXIT_VALUE:
+		if(x.pos>=0)
+			set_pos(x.pos);
+
+		v=frame.regs[x.reg];
+		break;
+
+	case GYS_EXIT_PRIM:
+		set_pos(x.pos);
+		v=get_prim(code->strs[x.type]);
+		break;
+
+	case GYS_EXIT_STMT:
+		set_pos(x.pos);
+		interp_next();
+		break;
+
+	default: // void
+		if(x.pos>=0)
+		{
+			set_pos(x.pos);
+			get_token();
+		}
+	}
+
+	// continuations
+	int i=x.cont;
+
+	while(i>=0)
+	{
+		const GYS_cont& c=code->conts[i];
+		GYS_ret_val t;
+
+		switch(c.kind)
+		{
+		case GYS_CONT_LOOP:
+			t=get_expr_loop(c.level, v);
+			break;
+
+		case GYS_CONT_PRIM_LOOP:
+			t=get_prim_loop(v);
+			break;
+
+		case GYS_CONT_CONVERT:
+			t=exec_converter(v, code->types[c.type]);
+			break;
+
+		case GYS_CONT_BINARY:
+			t=frame.ops[c.func].binary(this, frame.regs[c.reg], v); // processing operator
+			break;
+
+		case GYS_CONT_INDEX:
+			exam(GYS_RBRACKET);
+			t=v;
+			break;
+
+		case GYS_CONT_PRE_UNARY:
+			{
+				GYS_ret_val result=frame.ops[c.func].pre_unary(this, v); // processing operator
+
+				if(result.get_type_id()==code->types[c.type]) // ok
+					t=result;
+				else                                           // error
+					error("Prefix unary operator '"+string(gys_delim_str(c.code))+"' doesn't return '"+code->strs[c.type]+"' : ", result.get_type_name());
+			}
+			break;
+
+		case GYS_CONT_PAREN:
+			get_token();
+			if(tok_code!=GYS_RPAREN)
+			{
+				error("Expression anal: ')' expected: ", token);
+
+				v.clean();
+				i=code->conts[c.parent].parent; // without postfix operators
+				continue;
+			}
+			t=v;
+			break;
+
+		default: // resume callback
+			t=c.resume(this, v, c.args);
+		}
+
+		v.clean(); // not lvalue
+		v=t;
+
+		i=c.parent;
+	}
+
+	return v;
+}
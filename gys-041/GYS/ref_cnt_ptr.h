@@ -24,6 +24,12 @@ public:
       pointed to. */
   RefCntObject() : m_refcnt(0) {}
 
+  /** Copy constructor. The copy isn't pointed to yet. */
+  RefCntObject(const RefCntObject&) : m_refcnt(0) {}
+
+  /** Assignment operator. The reference count isn't copied. */
+  RefCntObject& operator= (const RefCntObject&) { return *this; }
+
   /** Add 1 to the reference count. */
   void addRef() { m_refcnt++; }
 
@@ -32,6 +38,9 @@ public:
       and the object should be deleted. */
   bool subRef() { return (--m_refcnt <= 0); }
 
+  /** Returns the reference count (1 - the only owner). */
+  int getRefCnt() const { return m_refcnt; }
+
 private:
   int m_refcnt;
 };
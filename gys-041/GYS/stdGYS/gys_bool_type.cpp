@@ -31,26 +31,11 @@
 
 #include "gys_int_type.h"
 
-class GYS_bool_user_val: public GYS_user_val
-{
-private:
-	bool val;
-
-public:
-	GYS_bool_user_val(bool b) : val(b) { }
-
-	string get_type_name() const {
-		return gys_bool_type;
-	}		
-
-	void* get_user_val() {
-		return &val;
-	}
-};
-
 GYS_ret_val& store(GYS_ret_val& val, bool bool_user_val)
 {
-	val.set_user_val( new GYS_bool_user_val(bool_user_val) );
+	static const GYS_type_id id=gys_type_id(gys_bool_type);
+
+	val.set_small_val(bool_user_val, id); // no allocation
 	return val;
 }
 
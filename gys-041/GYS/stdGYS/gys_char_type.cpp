@@ -32,26 +32,11 @@
 #include "gys_string_type.h"
 #include "gys_int_type.h"
 
-class GYS_char_user_val: public GYS_user_val
-{
-private:
-	char val;
-
-public:
-	GYS_char_user_val(char c) : val(c) { }
-
-	string get_type_name() const {
-		return gys_char_type;
-	}		
-
-	void* get_user_val() {
-		return &val;
-	}
-};
-
 GYS_ret_val& store(GYS_ret_val& val, char char_user_val)
 {
-	val.set_user_val( new GYS_char_user_val(char_user_val) );
+	static const GYS_type_id id=gys_type_id(gys_char_type);
+
+	val.set_small_val(char_user_val, id); // no allocation
 	return val;
 }
 
@@ -84,4 +84,9 @@ void add_convert_funcs(GYS* script)
 	
 	script->add_gys_func("ctoi", exec_ctoi);
 	script->add_gys_func("itoc", exec_itoc);
+
+	script->add_pure_gys_func("stoi");
+	script->add_pure_gys_func("stod");
+	script->add_pure_gys_func("ctoi");
+	script->add_pure_gys_func("itoc");
 }
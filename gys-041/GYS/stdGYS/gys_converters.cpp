@@ -34,6 +34,7 @@
 #include "gys_string_type.h"
 #include "gys_vector_type.h"
 #include "gys_function_type.h"
+#include "gys_matrix_type.h"
 
 #include <sstream>  // ostreamstring
 
@@ -85,14 +86,16 @@ GYS_ret_val convert_stoc(GYS* script, GYS_ret_val from_val)
 // vector -> vector[0] with warning (aux func)
 GYS_ret_val convert_from_vector(GYS* script, GYS_ret_val from_val, string Into_type_name)
 {
-	if(((GYS_vector_val)from_val).get_vector().size()<1)
+	GYS_vector_val vec=from_val; // shares the elements
+
+	if(vec.empty())
 	{
 		script->error("Conversion from '"+from_val.get_type_name()+"' into '"+Into_type_name+"' : vector is empty");
 		return GYS_ret_val();
 	}
 	
 	script->warning("Unsafe conversion from '"+from_val.get_type_name()+"' into '"+Into_type_name+"'.");
-	return script->exec_converter(*((GYS_vector_val)from_val)[0], Into_type_name);
+	return script->exec_converter(vec.at(0), Into_type_name);
 }
 
 // vector -> bool!
@@ -128,7 +131,7 @@ GYS_ret_val convert_vtof(GYS* script, GYS_ret_val from_val)
 // universal into vector conversion
 GYS_ret_val convert_into_vector(GYS* script, GYS_ret_val from_val)
 {
-	GYS_vector_val vec(from_val.get_type_name());
+	GYS_vector_val vec(from_val.get_type_id());
 	vec.push_back(from_val.get_value()); // not lvalue
 
 	return vec;
@@ -139,10 +142,11 @@ GYS_ret_val convert_vtos(GYS* script, GYS_ret_val from_val)
 {
 	script->warning("Unsafe conversion from '"+from_val.get_type_name()+"' into '"+gys_string_type+"'.");
 
+	GYS_vector_val vec=from_val; // shares the elements
 	string str="";
 		
-	for(unsigned i=0;i<((GYS_vector_val)from_val).get_vector().size();i++)
-		str+=(string)script->exec_converter( * ( ( (GYS_vector_val)from_val ) [i] ), gys_string_type );
+	for(unsigned i=0;i<vec.size();i++)
+		str+=(string)script->exec_converter( vec.at(i), gys_string_type );
 
 	return str;
 }
@@ -159,6 +163,68 @@ GYS_ret_val convert_stov(GYS* script, GYS_ret_val from_val)
 	return vec;
 }
 
+// matrix -> vector of rows (vectors of double which share the elements of the matrix)
+GYS_ret_val convert_mtov(GYS* script, GYS_ret_val from_val)
+{
+	GYS_matrix_val m=from_val;
+	GYS_vector_val vec(gys_vector_type);
+
+	for(unsigned i=0;i<m.get_rows();i++)
+		vec.push_back(m.row(i));
+
+	return vec;
+}
+
+// vector -> matrix (vector of rows or vector of numbers as one row)
+GYS_ret_val convert_vtom(GYS* script, GYS_ret_val from_val)
+{
+	GYS_vector_val vec=from_val;
+	vector<GYS_vector_val> rows;
+
+	if(vec.get_type_name()==gys_vector_type)
+	{
+		for(unsigned i=0;i<vec.size();i++)
+			rows.push_back(vec.at(i));
+	}
+	else if(!vec.empty())
+		rows.push_back(vec);
+
+	unsigned cols= rows.empty() ? 0 : rows[0].size();
+	GYS_matrix_val m(rows.size(), cols, 0.0);
+
+	for(unsigned i=0;i<rows.size();i++)
+	{
+		if(rows[i].size()!=cols)
+		{
+			script->error("Conversion from '"+(string)gys_vector_type+"' into '"+gys_matrix_type+"' : rows must have the same number of elements.");
+			return GYS_ret_val();
+		}
+
+		for(unsigned j=0;j<cols;j++)
+			m.set(i, j, script->exec_converter(rows[i].at(j), gys_double_type));
+	}
+
+	return m;
+}
+
+// matrix -> string (elements are separated by spaces, rows - by new lines)
+GYS_ret_val convert_mtos(GYS* script, GYS_ret_val from_val)
+{
+	GYS_matrix_val m=from_val;
+	ostringstream s;
+
+	for(unsigned i=0;i<m.get_rows();i++)
+	{
+		if(i)
+			s<<'\n';
+
+		for(unsigned j=0;j<m.get_cols();j++)
+			s<<(j ? " " : "")<<m.at(i, j);
+	}
+
+	return s.str(); // string
+}
+
 void add_converters(GYS* s)
 {
 	s->add_gys_converter(gys_double_type, gys_int_type,  convert_and_warn<double, int>);
@@ -193,4 +259,8 @@ void add_converters(GYS* s)
 	s->add_gys_converter(gys_vector_type, gys_string_type, convert_vtos);
 
 	s->add_gys_converter(gys_string_type, gys_vector_type, convert_stov);
+
+	s->add_gys_converter(gys_matrix_type, gys_vector_type, convert_mtov);
+	s->add_gys_converter(gys_vector_type, gys_matrix_type, convert_vtom);
+	s->add_gys_converter(gys_matrix_type, gys_string_type, convert_mtos);
 }
\ No newline at end of file
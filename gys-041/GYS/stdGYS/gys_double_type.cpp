@@ -29,26 +29,14 @@
 #include "gys_double_type.h" 
 #include "gys_type_stuff.cpp" // VC7 doesn't support export keyword with templates thus we include cpp-file
 
-class GYS_double_user_val: public GYS_user_val
-{
-private:
-	double val;
-
-public:
-	GYS_double_user_val(double d) : val(d) { }
-
-	string get_type_name() const {
-		return gys_double_type;
-	}		
-
-	void* get_user_val() {
-		return &val;
-	}
-};
+// int type name for quick operators (gys_int_type.h isn't included: store(int) must not be visible here)
+static const char* quick_int_type = "int";
 
 GYS_ret_val& store(GYS_ret_val& val, double double_user_val)
 {
-	val.set_user_val( new GYS_double_user_val(double_user_val) );
+	static const GYS_type_id id=gys_type_id(gys_double_type);
+
+	val.set_small_val(double_user_val, id); // no allocation
 	return val;
 }
 
@@ -97,6 +85,31 @@ void add_double_type(GYS* s)
 	s->add_post_unary_op("++", gys_double_type, op_post_inc<double>);
 	s->add_post_unary_op("--", gys_double_type, op_post_dec<double>);
 
+	// quick forms for int right operand (without int->double conversion)
+	s->add_quick_binary_op("=",  gys_double_type, quick_int_type, op_quick_assign<int, double>);
+	s->add_quick_binary_op("+=", gys_double_type, quick_int_type, op_quick<int, double, op_add_assign<double, double, double> >);
+	s->add_quick_binary_op("-=", gys_double_type, quick_int_type, op_quick<int, double, op_sub_assign<double, double, double> >);
+	s->add_quick_binary_op("*=", gys_double_type, quick_int_type, op_quick<int, double, op_mul_assign<double, double, double> >);
+	s->add_quick_binary_op("/=", gys_double_type, quick_int_type, op_quick<int, double, op_div_assign<double, double, double> >);
+
+	s->add_quick_binary_op("+", gys_double_type, quick_int_type, op_quick<int, double, op_add<double, double, double> >);
+	s->add_quick_binary_op("-", gys_double_type, quick_int_type, op_quick<int, double, op_sub<double, double, double> >);
+	s->add_quick_binary_op("*", gys_double_type, quick_int_type, op_quick<int, double, op_mul<double, double, double> >);
+	s->add_quick_binary_op("/", gys_double_type, quick_int_type, op_quick<int, double, op_div<double, double, double> >);
+
+	s->add_quick_binary_op("==", gys_double_type, quick_int_type, op_quick<int, double, op_equal<double, double, bool> >);
+	s->add_quick_binary_op("!=", gys_double_type, quick_int_type, op_quick<int, double, op_not_equal<double, double, bool> >);
+	s->add_quick_binary_op(">",  gys_double_type, quick_int_type, op_quick<int, double, op_greater<double, double, bool> >);
+	s->add_quick_binary_op("<",  gys_double_type, quick_int_type, op_quick<int, double, op_less<double, double, bool> >);
+	s->add_quick_binary_op(">=", gys_double_type, quick_int_type, op_quick<int, double, op_greater_or_equal<double, double, bool> >);
+	s->add_quick_binary_op("<=", gys_double_type, quick_int_type, op_quick<int, double, op_less_or_equal<double, double, bool> >);
+
+	s->add_quick_binary_op("&&", gys_double_type, quick_int_type, op_quick<int, double, op_and<double, double, bool> >);
+	s->add_quick_binary_op("||", gys_double_type, quick_int_type, op_quick<int, double, op_or<double, double, bool> >);
+
+	s->add_quick_post_unary_op("++", gys_double_type, op_post_inc<double>);
+	s->add_quick_post_unary_op("--", gys_double_type, op_post_dec<double>);
+
 	s->add_pre_unary_op("+",  gys_double_type, op_plus_unar<double>);
 	s->add_pre_unary_op("-",  gys_double_type, op_minus_unar<double>);
 	s->add_pre_unary_op("!",  gys_double_type, op_not<double>);
@@ -33,6 +33,7 @@
 #include "gys_general_func.h"
 #include "gys_thread_func.h"
 #include "gys_vector_func.h"
+#include "gys_matrix_func.h"
 
 void add_stdgys_funcs(GYS* s)
 {
@@ -44,4 +45,5 @@ void add_stdgys_funcs(GYS* s)
 	add_general_funcs(s);
 	add_thread_funcs(s);
 	add_vector_funcs(s);
+	add_matrix_funcs(s);
 }
\ No newline at end of file
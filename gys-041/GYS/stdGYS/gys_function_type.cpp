@@ -51,6 +51,11 @@ public:
 		return gys_function_type;
 	}		
 
+	GYS_type_id get_type_id() const {
+		static const GYS_type_id id=gys_type_id(gys_function_type);
+		return id;
+	}
+
 	void* get_user_val() {
 		return &val;
 	}
@@ -334,12 +339,14 @@ GYS_ret_val exec_defunc(GYS* s)
 		return GYS_ret_val();
 	}
 
+	GYS_ret_val func=GYS_function_val(ftype, fparams, fbody); // the variable and the result share the body
+
 	if(is_global)
-		s->add_global_var(fname, GYS_function_val(ftype, fparams, fbody) );
+		s->add_global_var(fname, func);
 	else
-		s->add_local_var(fname, GYS_function_val(ftype, fparams, fbody) );
+		s->add_local_var(fname, func);
 
-	return GYS_function_val(ftype, fparams, fbody);
+	return func;
 }
 
 // fn ret_type (...) { ... }
@@ -484,33 +491,60 @@ DWORD WINAPI thread_func(LPVOID lpParam)
 	return 0; 
 } 
 
-GYS_ret_val op_post_func(GYS* script, GYS_ret_val l)
+// reads arguments of the call till ")"
+static void read_args(GYS* script, GYS_function_val* func, vector<GYS_ret_val>& args)
 {
-	// read func
-	GYS_function_val func=l;
+	args.reserve(func->params.size());
 
-	istringstream* in=new istringstream(func.body);
-	GYS fscript("function", func.ret_type, in);
-		
-	// read arguments
-	fscript.add_local_var("@SELF", l); // add itself for easy recursion
-
-	string pname;
-	GYS_ret_val pval;
-	for(unsigned i=0;i<func.params.size();i++)
+	for(unsigned i=0;i<func->params.size();i++)
 	{
-		pname=func.params[i].second; // param name
-		pval=script->get_val(func.params[i].first).get_value(); //argument value
-		
-		fscript.add_local_var(pname, pval.get_value()); // add argument as a new var to func-script
+		args.push_back(script->get_val(func->params[i].first).get_value()); //argument value
 
-		if( i<(func.params.size()-1) ) // check for comma
+		if( i<(func->params.size()-1) ) // check for comma
 			script->exam(",");
 	}
 
 	script->exam(")");
+}
+
+bool exec_tail_call(GYS* s)
+{
+	if(!s->is_tail_call())
+		return false;
+
+	s->get_token();
+	string name=s->get_tok_str();
+
+	// the function returns the value of the same type (no conversion is needed)
+	GYS_ret_val fval;
+	if(s->is_var(name))
+		fval=s->get_var_val(name).get_value();
+
+	if(fval.get_type_name()!=gys_function_type || ((GYS_function_val*)fval)->ret_type!=s->get_ret_type())
+	{
+		s->putback_tok();
+		return false;
+	}
 
-	script->copy_params_to_sub(&fscript);
+	s->exam("(");
+
+	vector<GYS_ret_val> args;
+	read_args(s, fval, args);
+
+	s->set_tail_call(fval, args); // made after argument errors too (as op_post_func() does)
+
+	return true;
+}
+
+GYS_ret_val op_post_func(GYS* script, GYS_ret_val l)
+{
+	// read func
+	GYS_ret_val fval=l.get_value(); // keeps the function during the call
+	GYS_function_val* func=fval;
+
+	// read arguments (before the call frame is taken: they can call functions too)
+	vector<GYS_ret_val> args;
+	read_args(script, func, args);
 
 	// check for thread spec
 	script->get_token();
@@ -519,10 +553,18 @@ GYS_ret_val op_post_func(GYS* script, GYS_ret_val l)
 		if(!script->exam("thread")) // thread spec
 			return GYS_ret_val(); // error
 
-		if(func.ret_type!=gys_void_type)
+		if(func->ret_type!=gys_void_type)
 			script->warning((string)gys_function_type+"():thread:  function has not void type of return value");
-		
-		pair<GYS, istringstream*>* param=new pair<GYS, istringstream*>(fscript, in); // will be destroyed in thread_func
+
+		istringstream* in=new istringstream(func->body->get_text()); // the thread doesn't share the token array
+		pair<GYS, istringstream*>* param=new pair<GYS, istringstream*>(GYS("function", func->ret_type, in), in); // will be destroyed in thread_func
+		GYS& fscript=param->first; // only the thread uses it after CreateThread()
+
+		fscript.add_arg_var("@SELF", l); // add itself for easy recursion
+		for(unsigned i=0;i<args.size();i++)
+			fscript.add_arg_var(func->params[i].second, args[i]); // add argument as a new var to func-script
+
+		script->copy_params_to_sub(&fscript, true); // the thread gets its own language definition and code
 	    
 		DWORD dwThreadId; 
 				
@@ -531,11 +573,50 @@ GYS_ret_val op_post_func(GYS* script, GYS_ret_val l)
 	else
 		script->putback_tok();
 
-	fscript.disable(GYS_ESC); // don't process esc-chars again
-	fscript.interp(); // interp func
-	delete in;
+	GYS_ret_val result;
+
+	for(;;) // tail calls of the function are made in the same call frame
+	{
+		// the sub-script of this call level is reused
+		GYS* fscript=script->begin_call("function", func->ret_type, func->body);
+		istringstream* in=0; // input of the new sub-script (if the reused one is running)
+
+		if(!fscript)
+		{
+			in=new istringstream(func->body->get_text());
+			fscript=new GYS("function", func->ret_type, in);
+			script->copy_params_to_sub(fscript);
+		}
+
+		fscript->add_arg_var("@SELF", l); // add itself for easy recursion
+		for(unsigned i=0;i<args.size();i++)
+			fscript->add_arg_var(func->params[i].second, args[i]); // add argument as a new var to func-script
+
+		fscript->disable(GYS_ESC); // don't process esc-chars again
+		fscript->allow_tail_calls();
+		fscript->interp(); // interp func
+
+		bool tail=fscript->get_tail_call(fval, args);
+		if(!tail)
+			result=fscript->get_ret_val();
+
+		if(in)
+		{
+			delete fscript;
+			delete in;
+		}
+		else
+			script->end_call();
+
+		if(!tail)
+			break;
+
+		func=fval;
+		l.clean(); // not lvalue
+		l=fval;
+	}
 
-	return fscript.get_ret_val();
+	return result;
 }
 
 void add_function_type(GYS* script)
@@ -32,11 +32,15 @@
 typedef vector< pair<string, string> > GYS_func_params;
 
 //! Function value.
+/*!
+	The body is shared by all the copies of the value, it's lexed and compiled once
+	in GYS_PRETOKENIZE mode (see GYS_source).
+*/
 struct GYS_function_val
 {
-	string ret_type;        //!< return type
-	GYS_func_params params; //!< parameters
-	string body;            //!< function body code
+	string ret_type;                 //!< return type
+	GYS_func_params params;          //!< parameters
+	RefCntPointer<GYS_source> body;  //!< function body code
 
 	//! Constructor.
     /*!
@@ -46,7 +50,7 @@ struct GYS_function_val
     */
 
 	GYS_function_val(string return_type=gys_void_type, GYS_func_params func_params=GYS_func_params(), string fbody="")
-		: ret_type(return_type), params(func_params), body(fbody) {}
+		: ret_type(return_type), params(func_params), body(new GYS_source(fbody)) {}
 };
 
 static const char* gys_function_type = "function"; // function stdGYS type
@@ -64,4 +68,7 @@ GYS_ret_val exec_defunc(GYS* s); // defines new function variable (more readable
 // fn ret_type (...) { ... }
 GYS_ret_val exec_func(GYS* s);   // return function value (more readable syntax)
 
+// return f(...) - the caller of the script makes the call of f in the same call frame (see GYS::set_tail_call())
+bool exec_tail_call(GYS* s);     // false - it's not the tail call of a function value
+
 #endif
\ No newline at end of file
@@ -31,26 +31,11 @@
 
 #include "gys_double_type.h"
 
-class GYS_int_user_val: public GYS_user_val
-{
-private:
-	int val;
-
-public:
-	GYS_int_user_val(int i) : val(i) { }
-
-	string get_type_name() const {
-		return gys_int_type;
-	}		
-
-	void* get_user_val() {
-		return &val;
-	}
-};
-
 GYS_ret_val& store(GYS_ret_val& val, int int_user_val)
 {
-	val.set_user_val( new GYS_int_user_val(int_user_val) );
+	static const GYS_type_id id=gys_type_id(gys_int_type);
+
+	val.set_small_val(int_user_val, id); // no allocation
 	return val;
 }
 
@@ -101,6 +86,31 @@ void add_int_type(GYS* s)
 	s->add_post_unary_op("++", gys_int_type, op_post_inc<int>);
 	s->add_post_unary_op("--", gys_int_type, op_post_dec<int>);
 
+	// quick forms for int right operand (without int->double conversion)
+	s->add_quick_binary_op("=",  gys_int_type, gys_int_type, op_quick_assign<int, double>);
+	s->add_quick_binary_op("+=", gys_int_type, gys_int_type, op_quick<int, double, op_add_assign<int, double, int> >);
+	s->add_quick_binary_op("-=", gys_int_type, gys_int_type, op_quick<int, double, op_sub_assign<int, double, int> >);
+	s->add_quick_binary_op("*=", gys_int_type, gys_int_type, op_quick<int, double, op_mul_assign<int, double, int> >);
+	s->add_quick_binary_op("/=", gys_int_type, gys_int_type, op_quick<int, double, op_div_assign<int, double, int> >);
+
+	s->add_quick_binary_op("+", gys_int_type, gys_int_type, op_quick<int, double, op_add<int, double, double> >);
+	s->add_quick_binary_op("-", gys_int_type, gys_int_type, op_quick<int, double, op_sub<int, double, double> >);
+	s->add_quick_binary_op("*", gys_int_type, gys_int_type, op_quick<int, double, op_mul<int, double, double> >);
+	s->add_quick_binary_op("/", gys_int_type, gys_int_type, op_quick<int, double, op_div<int, double, double> >);
+
+	s->add_quick_binary_op("==", gys_int_type, gys_int_type, op_quick<int, double, op_equal<int ,double, bool> >);
+	s->add_quick_binary_op("!=", gys_int_type, gys_int_type, op_quick<int, double, op_not_equal<int, double, bool> >);
+	s->add_quick_binary_op(">",  gys_int_type, gys_int_type, op_quick<int, double, op_greater<int, double, bool> >);
+	s->add_quick_binary_op("<",  gys_int_type, gys_int_type, op_quick<int, double, op_less<int, double, bool> >);
+	s->add_quick_binary_op(">=", gys_int_type, gys_int_type, op_quick<int, double, op_greater_or_equal<int, double, bool> >);
+	s->add_quick_binary_op("<=", gys_int_type, gys_int_type, op_quick<int, double, op_less_or_equal<int, double, bool> >);
+
+	s->add_quick_binary_op("&&", gys_int_type, gys_int_type, op_quick<int, double, op_and<int, double, bool> >);
+	s->add_quick_binary_op("||", gys_int_type, gys_int_type, op_quick<int, double, op_or<int, double, bool> >);
+
+	s->add_quick_post_unary_op("++", gys_int_type, op_post_inc<int>);
+	s->add_quick_post_unary_op("--", gys_int_type, op_post_dec<int>);
+
 	s->add_pre_unary_op("+",  gys_int_type, op_plus_unar<int>);
 	s->add_pre_unary_op("-",  gys_int_type, op_minus_unar<int>);
 	s->add_pre_unary_op("!",  gys_int_type, op_not<int>);
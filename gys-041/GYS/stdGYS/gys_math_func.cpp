@@ -320,4 +320,11 @@ void add_math_funcs(GYS* script)
 	script->add_gys_func("tan",  exec_tan);
 	script->add_gys_func("atan", exec_atan);
 	script->add_gys_func("tanh", exec_tanh);
+
+	// everything except random numbers is pure (see GYS_OPT_HOIST)
+	const char* pure[]={ "abs", "exp", "log", "pow", "sqrt", "max", "min", "mod", "floor", "ceil",
+		"sin", "asin", "sinh", "cos", "acos", "cosh", "tan", "atan", "tanh" };
+
+	for(unsigned i=0;i<sizeof(pure)/sizeof(pure[0]);i++)
+		script->add_pure_gys_func(pure[i]);
 }
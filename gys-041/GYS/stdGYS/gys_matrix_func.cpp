@@ -0,0 +1,198 @@
+/******************************************************************************
+ *	 GYS - library for developing interpreters of scripting languages,        *
+ *                                                                            *
+ *	 Copyright (C) 2004  Govoruschenko Yuri Y.                                *
+ *	 E-mail: ygy@users.sourceforge.net                                        *
+ *	 Web: gys.sourceforge.net                                                 *
+ *                                                                            *
+ *   This library is free software; you can redistribute it and/or            *
+ *   modify it under the terms of the GNU Lesser General Public               *
+ *   License as published by the Free Software Foundation; either             *
+ *   version 2.1 of the License, or (at your option) any later version.       *
+ *                                                                            *
+ *   This library is distributed in the hope that it will be useful,          *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU        *
+ *   Lesser General Public License for more details.                          *
+ *                                                                            *
+ *   You should have received a copy of the GNU Lesser General Public         *
+ *   License along with this library; if not, write to the Free Software      *
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA *
+ ******************************************************************************/
+
+/*! \file
+    \brief Source file for stdGYS functions for matrices.
+*/
+
+#include "gys_matrix_func.h"
+
+#include "gys_matrix_type.h"
+#include "gys_vector_type.h"
+#include "gys_int_type.h"
+
+// <matrix>
+static GYS_matrix_val get_matrix_arg(GYS* script)
+{
+	script->exam("(");
+
+	GYS_matrix_val m=script->get_val(gys_matrix_type);
+
+	script->exam(")");
+
+	return m;
+}
+
+GYS_ret_val exec_mrows(GYS* script)
+{
+	return (int)get_matrix_arg(script).get_rows();
+}
+
+GYS_ret_val exec_mcols(GYS* script)
+{
+	return (int)get_matrix_arg(script).get_cols();
+}
+
+GYS_ret_val exec_mset(GYS* script)
+{
+	script->exam("(");
+
+	GYS_ret_val m=script->get_val(gys_matrix_type);
+
+	if(!m.is_lvalue())
+		script->error("mset(): argument 1 must be lvalue");
+
+	script->exam(",");
+	int i=script->get_val(gys_int_type);
+	script->exam(",");
+	int j=script->get_val(gys_int_type);
+	script->exam(",");
+	double val=script->get_val(gys_vector_double_type);
+
+	script->exam(")");
+
+	GYS_matrix_val* mp=m;
+	if(!mp)
+		return GYS_ret_val();
+
+	if(i<0 || (unsigned)i>=mp->get_rows() || j<0 || (unsigned)j>=mp->get_cols())
+	{
+		script->error("mset(): invalid index");
+		return GYS_ret_val();
+	}
+
+	mp->set(i, j, val);
+	
+	return *mp;
+}
+
+GYS_ret_val exec_mtranspose(GYS* script)
+{
+	return get_matrix_arg(script).transpose();
+}
+
+GYS_ret_val exec_mscale(GYS* script)
+{
+	script->exam("(");
+
+	GYS_matrix_val m=script->get_val(gys_matrix_type);
+
+	script->exam(",");
+
+	double k=script->get_val(gys_vector_double_type);
+
+	script->exam(")");
+
+	return m.scale(k);
+}
+
+// element-wise operation of matrices of the same size
+static GYS_ret_val exec_matrix_elementwise(GYS* script, GYS_vector_op op, const string& name)
+{
+	script->exam("(");
+
+	GYS_matrix_val l=script->get_val(gys_matrix_type);
+
+	script->exam(",");
+
+	GYS_matrix_val r=script->get_val(gys_matrix_type);
+
+	script->exam(")");
+
+	if(l.get_rows()!=r.get_rows() || l.get_cols()!=r.get_cols())
+	{
+		script->error(name+"(): sizes of matrices differ");
+		return GYS_ret_val();
+	}
+
+	GYS_matrix_val result;
+	if(!l.elementwise(op, r, result))
+	{
+		script->error(name+"(): divisor can't be 0");
+		return GYS_ret_val();
+	}
+
+	return result;
+}
+
+GYS_ret_val exec_mmul_elems(GYS* script) { return exec_matrix_elementwise(script, GYS_VECTOR_MUL, "mmul_elems"); }
+GYS_ret_val exec_mdiv_elems(GYS* script) { return exec_matrix_elementwise(script, GYS_VECTOR_DIV, "mdiv_elems"); }
+
+GYS_ret_val exec_mrow_sums(GYS* script)
+{
+	return get_matrix_arg(script).row_sums();
+}
+
+GYS_ret_val exec_mcol_sums(GYS* script)
+{
+	return get_matrix_arg(script).col_sums();
+}
+
+GYS_ret_val exec_mrow_means(GYS* script)
+{
+	GYS_matrix_val m=get_matrix_arg(script);
+
+	if(!m.get_cols())
+	{
+		script->error("mrow_means(): matrix has no columns");
+		return GYS_ret_val();
+	}
+
+	return m.row_sums(true);
+}
+
+GYS_ret_val exec_mcol_means(GYS* script)
+{
+	GYS_matrix_val m=get_matrix_arg(script);
+
+	if(!m.get_rows())
+	{
+		script->error("mcol_means(): matrix has no rows");
+		return GYS_ret_val();
+	}
+
+	return m.col_sums(true);
+}
+
+void add_matrix_funcs(GYS* script)
+{
+	script->add_gys_func("mrows", exec_mrows);
+	script->add_gys_func("mcols", exec_mcols);
+	script->add_gys_func("mset",  exec_mset);
+
+	script->add_gys_func("mtranspose", exec_mtranspose);
+	script->add_gys_func("mscale",     exec_mscale);
+	script->add_gys_func("mmul_elems", exec_mmul_elems);
+	script->add_gys_func("mdiv_elems", exec_mdiv_elems);
+
+	script->add_gys_func("mrow_sums",  exec_mrow_sums);
+	script->add_gys_func("mcol_sums",  exec_mcol_sums);
+	script->add_gys_func("mrow_means", exec_mrow_means);
+	script->add_gys_func("mcol_means", exec_mcol_means);
+
+	// results depend only on the arguments (see GYS_OPT_HOIST)
+	const char* pure[]={ "mrows", "mcols", "mtranspose", "mscale", "mmul_elems", "mdiv_elems",
+		"mrow_sums", "mcol_sums", "mrow_means", "mcol_means" };
+
+	for(unsigned i=0;i<sizeof(pure)/sizeof(pure[0]);i++)
+		script->add_pure_gys_func(pure[i]);
+}
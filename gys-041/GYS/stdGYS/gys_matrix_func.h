@@ -0,0 +1,49 @@
+/******************************************************************************
+ *	 GYS - library for developing interpreters of scripting languages,        *
+ *                                                                            *
+ *	 Copyright (C) 2004  Govoruschenko Yuri Y.                                *
+ *	 E-mail: ygy@users.sourceforge.net                                        *
+ *	 Web: gys.sourceforge.net                                                 *
+ *                                                                            *
+ *   This library is free software; you can redistribute it and/or            *
+ *   modify it under the terms of the GNU Lesser General Public               *
+ *   License as published by the Free Software Foundation; either             *
+ *   version 2.1 of the License, or (at your option) any later version.       *
+ *                                                                            *
+ *   This library is distributed in the hope that it will be useful,          *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU        *
+ *   Lesser General Public License for more details.                          *
+ *                                                                            *
+ *   You should have received a copy of the GNU Lesser General Public         *
+ *   License along with this library; if not, write to the Free Software      *
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA *
+ ******************************************************************************/
+
+/*! \file
+    \brief Header file for stdGYS functions for matrices.
+*/
+
+#ifndef __GYS_FUNC_MATRIX_
+#define __GYS_FUNC_MATRIX_
+
+#include "..\gys.h"
+
+void add_matrix_funcs(GYS* script);
+
+GYS_ret_val exec_mrows(GYS* script); // int mrows(<matrix>)
+GYS_ret_val exec_mcols(GYS* script); // int mcols(<matrix>)
+GYS_ret_val exec_mset(GYS* script);  // matrix mset(<matrix>, <int>, <int>, <double>)
+
+GYS_ret_val exec_mtranspose(GYS* script);  // matrix mtranspose(<matrix>)
+GYS_ret_val exec_mscale(GYS* script);      // matrix mscale(<matrix>, <double>)
+GYS_ret_val exec_mmul_elems(GYS* script);  // matrix mmul_elems(<matrix>, <matrix>)
+GYS_ret_val exec_mdiv_elems(GYS* script);  // matrix mdiv_elems(<matrix>, <matrix>)
+
+// reductions of rows or columns (sums of rows are computed pairwise)
+GYS_ret_val exec_mrow_sums(GYS* script);  // vector mrow_sums(<matrix>) - vector of double
+GYS_ret_val exec_mcol_sums(GYS* script);  // vector mcol_sums(<matrix>) - vector of double
+GYS_ret_val exec_mrow_means(GYS* script); // vector mrow_means(<matrix>) - vector of double
+GYS_ret_val exec_mcol_means(GYS* script); // vector mcol_means(<matrix>) - vector of double
+
+#endif
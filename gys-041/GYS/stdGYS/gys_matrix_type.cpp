@@ -0,0 +1,460 @@
+/******************************************************************************
+ *	 GYS - library for developing interpreters of scripting languages,        *
+ *                                                                            *
+ *	 Copyright (C) 2004  Govoruschenko Yuri Y.                                *
+ *	 E-mail: ygy@users.sourceforge.net                                        *
+ *	 Web: gys.sourceforge.net                                                 *
+ *                                                                            *
+ *   This library is free software; you can redistribute it and/or            *
+ *   modify it under the terms of the GNU Lesser General Public               *
+ *   License as published by the Free Software Foundation; either             *
+ *   version 2.1 of the License, or (at your option) any later version.       *
+ *                                                                            *
+ *   This library is distributed in the hope that it will be useful,          *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU        *
+ *   Lesser General Public License for more details.                          *
+ *                                                                            *
+ *   You should have received a copy of the GNU Lesser General Public         *
+ *   License along with this library; if not, write to the Free Software      *
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA *
+ ******************************************************************************/
+
+/*! 
+  \file
+  \brief Source file for stdGYS matrix type.
+
+*/
+
+#include "gys_matrix_type.h"
+#include "gys_type_stuff.cpp"
+
+#include "gys_int_type.h"
+
+
+class GYS_matrix_user_val: public GYS_user_val
+{
+private:
+	GYS_matrix_val val;
+
+public:
+	GYS_matrix_user_val(GYS_matrix_val v) : val(v) { }
+
+	string get_type_name() const {
+		return gys_matrix_type;
+	}		
+
+	GYS_type_id get_type_id() const {
+		static const GYS_type_id id=gys_type_id(gys_matrix_type);
+		return id;
+	}
+
+	void* get_user_val() {
+		return &val;
+	}
+};
+
+GYS_ret_val& store(GYS_ret_val& val, GYS_matrix_val matrix_user_val)
+{
+	val.set_user_val( new GYS_matrix_user_val(matrix_user_val) );
+	return val;
+}
+
+// {{v00, v01, ... }, {v10, v11, ... }, ... } - rows of elements (of double)
+// [rows, cols]:val                           - rows x cols elements (=val)
+GYS_ret_val get_matrix_val(GYS* s)
+{
+	s->get_token();
+
+	if(s->get_tok_code()==GYS_LBRACKET) // [rows, cols]:val
+	{
+		int rows=s->get_val(gys_int_type);
+		s->exam(",");
+		int cols=s->get_val(gys_int_type);
+
+		if(!s->exam("]"))
+			return GYS_ret_val();
+
+		if(!s->exam(":"))
+			return GYS_ret_val();
+
+		double val=s->get_val(gys_vector_double_type);
+
+		if(rows<0 || cols<0 || !GYS_matrix_val::valid_size(rows, cols))
+		{
+			s->error("'"+(string)gys_matrix_type+"' getting: invalid size.");
+			return GYS_ret_val();
+		}
+
+		return GYS_matrix_val(rows, cols, val);
+	}
+	
+	if(s->get_tok_code()!=GYS_LBRACE)
+	{
+		s->error("'"+(string)gys_matrix_type+"' getting: '{' or '[' expected: ", s->get_tok_str());
+		return GYS_ret_val();
+	}
+
+	// read the rows
+	vector< vector<double> > rows;
+
+	s->get_token();
+	if(s->get_tok_code()!=GYS_RBRACE) // {} - possible
+	{
+		s->putback_tok();
+		for(;;)
+		{
+			if(!s->exam("{"))
+				return GYS_ret_val();
+
+			rows.push_back(vector<double>());
+
+			s->get_token();
+			if(s->get_tok_code()!=GYS_RBRACE)
+			{
+				s->putback_tok();
+				for(;;)
+				{
+					rows.back().push_back(s->get_val(gys_vector_double_type));
+
+					s->get_token();
+					if(s->get_tok_code()==GYS_RBRACE)
+						break;
+
+					s->putback_tok(); // elements are separated by commas
+					if(!s->exam(","))
+						return GYS_ret_val();
+				}
+			}
+
+			if(rows.back().size()!=rows[0].size())
+			{
+				s->error("'"+(string)gys_matrix_type+"' getting: rows must have the same number of elements.");
+				return GYS_ret_val();
+			}
+
+			s->get_token();
+			if(s->get_tok_code()==GYS_RBRACE)
+				break;
+
+			s->putback_tok(); // rows are separated by commas
+			if(!s->exam(","))
+				return GYS_ret_val();
+		}
+	}
+
+	unsigned cols= rows.empty() ? 0 : rows[0].size();
+	GYS_matrix_val m(rows.size(), cols, 0.0);
+
+	for(unsigned i=0; i<rows.size(); i++)
+		for(unsigned j=0; j<cols; j++)
+			m.set(i, j, rows[i][j]);
+
+	return m;
+}
+
+// matrix[int] - returns the row as non-lvalue slice of the elements
+GYS_ret_val op_index_matrix(GYS* script, GYS_ret_val l, GYS_ret_val r)
+{
+	GYS_matrix_val* m=l;
+	int index=r;
+
+	if(index<0 || (unsigned)index>=m->get_rows()) // error
+	{
+		script->error((string)gys_matrix_type+"[]: invalid index");
+		return GYS_ret_val();
+	}
+
+	return m->row(index);
+}
+
+// matrix+matrix, matrix-matrix (element-wise)
+template<GYS_vector_op op> GYS_ret_val op_elementwise_matrix(GYS* script, GYS_ret_val l, GYS_ret_val r)
+{
+	GYS_matrix_val result;
+
+	if(!((GYS_matrix_val)l).elementwise(op, (GYS_matrix_val)r, result))
+	{
+		script->error("'"+(string)gys_matrix_type+"' "+(op==GYS_VECTOR_ADD ? "+" : "-")+" '"+gys_matrix_type+"' : sizes of matrices differ.");
+		return GYS_ret_val();
+	}
+
+	return result;
+}
+
+// matrix*matrix (matrix product)
+GYS_ret_val op_mul_matrix(GYS* script, GYS_ret_val l, GYS_ret_val r)
+{
+	GYS_matrix_val result;
+
+	if(!((GYS_matrix_val)l).multiply((GYS_matrix_val)r, result))
+	{
+		if(((GYS_matrix_val)l).get_cols()!=((GYS_matrix_val)r).get_rows())
+			script->error("'"+(string)gys_matrix_type+"' * '"+gys_matrix_type+"' : columns of left operand must be equal to rows of right operand.");
+		else
+			script->error("'"+(string)gys_matrix_type+"' * '"+gys_matrix_type+"' : the product is too large.");
+
+		return GYS_ret_val();
+	}
+
+	return result;
+}
+
+// range op matrix(low~up) - returns rows [low; up] as non-lvalue matrix (the elements aren't copied)
+GYS_ret_val op_post_range_matrix(GYS* script, GYS_ret_val l)
+{
+	int low=script->get_val(gys_int_type);
+
+	// '~' check
+	script->exam("~");
+	
+	int up=script->get_val(gys_int_type);
+
+    script->exam(")");
+
+	GYS_matrix_val m=l;
+
+	if(low>up)
+	{
+		script->error("'"+(string)gys_matrix_type+"' (int~int) : lower index > upper index.");
+		return GYS_ret_val();
+	}
+
+	if(low<0 || (unsigned)up>=m.get_rows())
+	{
+		script->error("'"+(string)gys_matrix_type+"' (int~int) : invalid index.");
+		return GYS_ret_val();
+	}
+
+	return m.row_range(low, up-low+1);
+}
+
+void add_matrix_type(GYS* s)
+{
+	s->add_gys_type(gys_matrix_type, get_matrix_val);
+	s->add_gys_func(gys_matrix_type, exec_type_name);
+
+	s->add_binary_op("=", gys_matrix_type, gys_matrix_type, op_assign);
+
+	s->add_binary_op("[", gys_matrix_type, gys_int_type, op_index_matrix);
+	s->add_binary_op("+", gys_matrix_type, gys_matrix_type, op_elementwise_matrix<GYS_VECTOR_ADD>);
+	s->add_binary_op("-", gys_matrix_type, gys_matrix_type, op_elementwise_matrix<GYS_VECTOR_SUB>);
+	s->add_binary_op("*", gys_matrix_type, gys_matrix_type, op_mul_matrix);
+
+	s->add_post_unary_op("(", gys_matrix_type, op_post_range_matrix);
+}
+
+//--------------------------GYS matrix value-------------------------------
+// edge of the blocks of the kernels (blocks of three matrices fit into L1/L2 cache)
+static const unsigned GYS_MATRIX_BLOCK=64;
+
+static unsigned matrix_block_end(unsigned from, unsigned n)
+{
+	return n-from>GYS_MATRIX_BLOCK ? from+GYS_MATRIX_BLOCK : n;
+}
+
+// c+=a*b (a is n x m, b is m x p), the inner loop runs over the rows of b and c (it's vectorized)
+static void matrix_multiply(const double* a, const double* b, double* c, unsigned n, unsigned m, unsigned p)
+{
+	for(unsigned i0=0; i0<n; i0+=GYS_MATRIX_BLOCK)
+	{
+		unsigned i1=matrix_block_end(i0, n);
+
+		for(unsigned k0=0; k0<m; k0+=GYS_MATRIX_BLOCK)
+		{
+			unsigned k1=matrix_block_end(k0, m);
+
+			for(unsigned j0=0; j0<p; j0+=GYS_MATRIX_BLOCK)
+			{
+				unsigned j1=matrix_block_end(j0, p);
+
+				for(unsigned i=i0; i<i1; i++)
+				{
+					double* c_row=c+(size_t)i*p;
+
+					for(unsigned k=k0; k<k1; k++)
+					{
+						const double a_ik=a[(size_t)i*m+k];
+						const double* b_row=b+(size_t)k*p;
+
+						for(unsigned j=j0; j<j1; j++)
+							c_row[j]+=a_ik*b_row[j];
+					}
+				}
+			}
+		}
+	}
+}
+
+// t=transposed a (a is rows x cols)
+static void matrix_transpose(const double* a, double* t, unsigned rows, unsigned cols)
+{
+	for(unsigned i0=0; i0<rows; i0+=GYS_MATRIX_BLOCK)
+	{
+		unsigned i1=matrix_block_end(i0, rows);
+
+		for(unsigned j0=0; j0<cols; j0+=GYS_MATRIX_BLOCK)
+		{
+			unsigned j1=matrix_block_end(j0, cols);
+
+			for(unsigned i=i0; i<i1; i++)
+				for(unsigned j=j0; j<j1; j++)
+					t[(size_t)j*rows+i]=a[(size_t)i*cols+j];
+		}
+	}
+}
+
+GYS_matrix_val::GYS_matrix_val() : rows(0), cols(0), elems(gys_vector_double_type)
+{
+}
+
+GYS_matrix_val::GYS_matrix_val(unsigned r, unsigned c, double val) : rows(r), cols(c), elems(gys_vector_double_type)
+{
+	elems.resize(r*c, gys_vector_double_val(val));
+}
+
+GYS_matrix_val::GYS_matrix_val(unsigned r, unsigned c, GYS_vector_val e) : rows(r), cols(c), elems(e)
+{
+}
+
+bool GYS_matrix_val::valid_size(unsigned r, unsigned c)
+{
+	size_t max_elems=min((size_t)(unsigned)-1, vector<double>().max_size()); // sizes of vectors are unsigned
+
+	return c==0 || r<=max_elems/c;
+}
+
+unsigned GYS_matrix_val::get_rows() const
+{
+	return rows;
+}
+
+unsigned GYS_matrix_val::get_cols() const
+{
+	return cols;
+}
+
+double GYS_matrix_val::at(unsigned i, unsigned j) const
+{
+	return elems.get_doubles()[(size_t)i*cols+j];
+}
+
+void GYS_matrix_val::set(unsigned i, unsigned j, double val)
+{
+	elems.change_doubles()[(size_t)i*cols+j]=val;
+}
+
+GYS_vector_val GYS_matrix_val::get_elems() const
+{
+	return elems;
+}
+
+GYS_vector_val GYS_matrix_val::row(unsigned i) const
+{
+	return elems.slice(i*cols, cols);
+}
+
+GYS_matrix_val GYS_matrix_val::row_range(unsigned first, unsigned n) const
+{
+	return GYS_matrix_val(n, cols, elems.slice(first*cols, n*cols));
+}
+
+bool GYS_matrix_val::elementwise(GYS_vector_op op, const GYS_matrix_val& r, GYS_matrix_val& result) const
+{
+	if(op!=GYS_VECTOR_ADD && op!=GYS_VECTOR_SUB && op!=GYS_VECTOR_MUL && op!=GYS_VECTOR_DIV)
+		return false;
+
+	if(rows!=r.rows || cols!=r.cols)
+		return false;
+
+	if(elems.empty()) // no elements to compute
+	{
+		result=*this;
+		return true;
+	}
+
+	GYS_vector_val e;
+	if(!elems.elementwise(op, r.elems, e))
+		return false;
+
+	result=GYS_matrix_val(rows, cols, e);
+	return true;
+}
+
+GYS_matrix_val GYS_matrix_val::scale(double k) const
+{
+	GYS_matrix_val m=*this;
+
+	double* e=m.elems.change_doubles(); // copies the elements
+	size_t n=m.elems.size();
+
+	for(size_t i=0; i<n; i++)
+		e[i]*=k;
+
+	return m;
+}
+
+bool GYS_matrix_val::multiply(const GYS_matrix_val& r, GYS_matrix_val& result) const
+{
+	if(cols!=r.rows || !valid_size(rows, r.cols))
+		return false;
+
+	result=GYS_matrix_val(rows, r.cols, 0.0);
+
+	if(rows && cols && r.cols)
+		matrix_multiply(elems.get_doubles(), r.elems.get_doubles(), result.elems.change_doubles(), rows, cols, r.cols);
+
+	return true;
+}
+
+GYS_matrix_val GYS_matrix_val::transpose() const
+{
+	GYS_matrix_val t(cols, rows, 0.0);
+
+	if(rows && cols)
+		matrix_transpose(elems.get_doubles(), t.elems.change_doubles(), rows, cols);
+
+	return t;
+}
+
+GYS_vector_val GYS_matrix_val::row_sums(bool mean) const
+{
+	GYS_vector_val sums(gys_vector_double_type);
+	sums.resize(rows, gys_vector_double_val(0));
+
+	if(!cols)
+		return sums;
+
+	double* s=sums.change_doubles();
+	for(unsigned i=0; i<rows; i++)
+		row(i).reduce(mean ? GYS_VECTOR_MEAN : GYS_VECTOR_SUM, s[i]);
+
+	return sums;
+}
+
+GYS_vector_val GYS_matrix_val::col_sums(bool mean) const
+{
+	GYS_vector_val sums(gys_vector_double_type);
+	sums.resize(cols, gys_vector_double_val(0));
+
+	if(!rows || !cols)
+		return sums;
+
+	// rows are added one by one (the inner loop is vectorized)
+	const double* e=elems.get_doubles();
+	double* s=sums.change_doubles();
+
+	for(unsigned i=0; i<rows; i++)
+	{
+		const double* r=e+(size_t)i*cols;
+
+		for(unsigned j=0; j<cols; j++)
+			s[j]+=r[j];
+	}
+
+	if(mean)
+		for(unsigned j=0; j<cols; j++)
+			s[j]/=rows;
+
+	return sums;
+}
@@ -0,0 +1,172 @@
+/******************************************************************************
+ *	 GYS - library for developing interpreters of scripting languages,        *
+ *                                                                            *
+ *	 Copyright (C) 2004  Govoruschenko Yuri Y.                                *
+ *	 E-mail: ygy@users.sourceforge.net                                        *
+ *	 Web: gys.sourceforge.net                                                 *
+ *                                                                            *
+ *   This library is free software; you can redistribute it and/or            *
+ *   modify it under the terms of the GNU Lesser General Public               *
+ *   License as published by the Free Software Foundation; either             *
+ *   version 2.1 of the License, or (at your option) any later version.       *
+ *                                                                            *
+ *   This library is distributed in the hope that it will be useful,          *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU        *
+ *   Lesser General Public License for more details.                          *
+ *                                                                            *
+ *   You should have received a copy of the GNU Lesser General Public         *
+ *   License along with this library; if not, write to the Free Software      *
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA *
+ ******************************************************************************/
+
+/*! \file
+    \brief Header file for stdGYS matrix type.
+*/
+
+#ifndef __GYS_MATRIX_TYPE_
+#define __GYS_MATRIX_TYPE_
+
+#include "..\gys.h"
+#include "gys_vector_type.h"
+
+//! Matrix value.
+/*! 
+	Defined for use with GYS_ret_val to store stdGYS matrices of double elements.
+	The elements are kept row by row in one vector of double (see GYS_vector_val),
+	so the copies share them till one of the copies is changed (copy-on-write)
+	and the rows are slices of this vector.
+*/
+class GYS_matrix_val
+{
+private:
+	unsigned int rows;
+	unsigned int cols;
+	GYS_vector_val elems; // rows*cols unboxed doubles, row by row
+
+	GYS_matrix_val(unsigned int r, unsigned int c, GYS_vector_val e);
+
+public:
+	//! Constructor of empty matrix (0x0).
+	GYS_matrix_val();
+
+	//! Constructor.
+    /*!
+	  \param r number of rows.
+	  \param c number of columns (the size must be valid, see valid_size()).
+	  \param val value of the elements.
+    */
+	GYS_matrix_val(unsigned int r, unsigned int c, double val);
+
+	//! Checks if the matrix of the size can be created.
+    /*!
+	  \param r number of rows.
+	  \param c number of columns.
+	  \return <b>false</b> if the number of elements (r*c) overflows or exceeds the maximal size of the elements.
+    */
+	static bool valid_size(unsigned int r, unsigned int c);
+
+	//! Returns the number of rows.
+	unsigned int get_rows() const;
+
+	//! Returns the number of columns.
+	unsigned int get_cols() const;
+
+	//! Returns the value of the specified element.
+    /*!
+	  \param i row (must be less than get_rows()).
+	  \param j column (must be less than get_cols()).
+	  \return Value of the element.
+    */
+	double at(unsigned int i, unsigned int j) const;
+
+	//! Changes the value of the specified element.
+    /*!
+	  The elements are unshared before changing.
+
+	  \param i row (must be less than get_rows()).
+	  \param j column (must be less than get_cols()).
+	  \param val new value.
+    */
+	void set(unsigned int i, unsigned int j, double val);
+
+	//! Returns the elements of the matrix.
+    /*!
+	  \return Vector of double elements (row by row), it shares the elements of the matrix.
+    */
+	GYS_vector_val get_elems() const;
+
+	//! Returns the row as vector without copying the elements.
+    /*!
+	  \param i row (must be less than get_rows()).
+	  \return Slice of the elements (see GYS_vector_val::slice()).
+    */
+	GYS_vector_val row(unsigned int i) const;
+
+	//! Returns the rows as matrix without copying the elements.
+    /*!
+	  \param first first row.
+	  \param n number of rows (first+n mustn't exceed get_rows()).
+	  \return Matrix of n rows.
+    */
+	GYS_matrix_val row_range(unsigned int first, unsigned int n) const;
+
+	//! Applies the element-wise operation to the elements of matrices of the same size.
+    /*!
+	  \param op arithmetic operation (GYS_VECTOR_ADD, GYS_VECTOR_SUB, GYS_VECTOR_MUL or GYS_VECTOR_DIV).
+	  \param r right operand.
+	  \param result gets the matrix of the results.
+      \return <b>true</b> if function succeeded, <b>false</b> if the sizes differ,
+	  the operation isn't arithmetic or a divisor is 0.
+    */
+	bool elementwise(GYS_vector_op op, const GYS_matrix_val& r, GYS_matrix_val& result) const;
+
+	//! Multiplies all the elements by the number.
+    /*!
+	  \param k multiplier.
+	  \return Matrix of the products.
+    */
+	GYS_matrix_val scale(double k) const;
+
+	//! Computes the matrix product.
+    /*!
+	  The product is computed block by block, so the blocks of the operands stay in the cache.
+
+	  \param r right operand (its rows must be equal to the columns of this matrix).
+	  \param result gets the product.
+      \return <b>true</b> if function succeeded, <b>false</b> if the sizes don't match
+	  or the product is too large (see valid_size()).
+    */
+	bool multiply(const GYS_matrix_val& r, GYS_matrix_val& result) const;
+
+	//! Returns the transposed matrix (computed block by block).
+	GYS_matrix_val transpose() const;
+
+	//! Sums the elements of each row.
+    /*!
+	  Sums are computed pairwise (see GYS_vector_val::reduce()).
+
+	  \param mean if <b>true</b>, the sums are divided by the number of columns.
+	  \return Vector of double (one element for each row).
+    */
+	GYS_vector_val row_sums(bool mean=false) const;
+
+	//! Sums the elements of each column.
+    /*!
+	  \param mean if <b>true</b>, the sums are divided by the number of rows.
+	  \return Vector of double (one element for each column).
+    */
+	GYS_vector_val col_sums(bool mean=false) const;
+};
+
+static const char* gys_matrix_type = "matrix"; // matrix stdGYS type
+
+GYS_ret_val& store(GYS_ret_val& val, GYS_matrix_val matrix_user_val);
+
+// {{v00, v01, ... }, {v10, v11, ... }, ... } - rows of elements (of double)
+// [rows, cols]:val                           - rows x cols elements (=val)
+GYS_ret_val get_matrix_val(GYS* script);
+
+void add_matrix_type(GYS* script);
+
+#endif
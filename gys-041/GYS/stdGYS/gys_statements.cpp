@@ -27,27 +27,50 @@
 #include "gys_statements.h"
 
 #include "gys_bool_type.h"
+#include "gys_function_type.h"
+
+// stages of the statements (compiled code resumes them by interpretation)
+enum{
+	STAGE_START,      // from the beginning
+	STAGE_INIT,       // for: in init-code
+	STAGE_CONDITION,  // if: before "(" of the condition
+	STAGE_AFTER_COND, // condition value was read
+	STAGE_BODY,       // in the body
+	STAGE_ELSE_BODY,  // if: in else-body
+	STAGE_LOOP_CODE   // for: in loop-code
+};
+
+// body state for resume callbacks: number of unpaired "{" and whether the statement was interpreted
+static long body_state(int more, bool after_stmt)
+{
+	return more*2+(after_stmt ? 1 : 0);
+}
+
+static const long body_start=2; // body_state(1, false)
 
 // interpretes till the first unpaired odd "}" is found
+// more - number of unpaired "{", after_stmt - statement was just interpreted
 // returns false if GYS_EOF found
-bool interp_to_odd_cbracket(GYS* s)
+bool interp_to_odd_cbracket(GYS* s, int more=1, bool after_stmt=false)
 {
-	int more=1;
-
-	while(s->get_tok_type()!=GYS_EOF && more)
+	while(after_stmt || (s->get_tok_type()!=GYS_EOF && more))
 	{
-		s->get_token();
-		if(s->get_tok_type()==GYS_DELIMETER && s->get_tok_str()=="}") // {} is possible
-			break;
-		else
-			s->putback_tok();
+		if(!after_stmt)
+		{
+			s->get_token();
+			if(s->get_tok_code()==GYS_RBRACE) // {} is possible
+				break;
+			else
+				s->putback_tok();
 
-		s->interp_next();
+			s->interp_next();
+		}
+		after_stmt=false;
 
 		s->get_token();		
-		if(s->get_tok_type()==GYS_DELIMETER && s->get_tok_str()=="{") 
+		if(s->get_tok_code()==GYS_LBRACE) 
 			more++; // we'll miss one }
-		else if(s->get_tok_type()==GYS_DELIMETER && s->get_tok_str()=="}")
+		else if(s->get_tok_code()==GYS_RBRACE)
 			more--;
 		else
 			s->putback_tok();
@@ -59,31 +82,31 @@ bool interp_to_odd_cbracket(GYS* s)
 	return true;
 }
 
-// interpret to endstr-token(GYS::exam param syntax)
+// interpretes the body from the state (see body_state())
+static bool interp_body(GYS* s, long state)
+{
+	return interp_to_odd_cbracket(s, state/2, state%2!=0);
+}
+
+// interpret to end-delimeter
+// after_stmt - statement was just interpreted
 // returns false if GYS_EOF found
-bool interp_to(GYS* s, string endstr)
+bool interp_to(GYS* s, GYS_delim end, bool after_stmt=false)
 {
 	do
 	{
-		s->get_token();		
+		if(!after_stmt)
+		{
+			s->get_token();		
 
-		string cmp_to=s->get_tok_str();
+			if(s->get_tok_code()==end) // end-delimeter found
+				break;
+			else                 // continue interpreting
+				s->putback_tok();
 
-		if(s->get_tok_type()==GYS_STRING)
-		{
-			cmp_to="\""+cmp_to+"\"";
-		}
-		else if(s->get_tok_type()==GYS_CHAR)
-		{
-			cmp_to="\'"+cmp_to+"\'";
+			s->interp_next();
 		}
-		
-		if(cmp_to==endstr)   // 'endstr'-token found
-			break;
-		else                 // continue interpreting
-			s->putback_tok();
-
-		s->interp_next();
+		after_stmt=false;
 	}	
 	while(s->get_tok_type()!=GYS_EOF);
 
@@ -93,52 +116,114 @@ bool interp_to(GYS* s, string endstr)
 	return true;
 }
 
-// move to odd endstr-token(GYS::exam param syntax)
+// moves to the first unpaired odd "}" (curly)
 // returns false if GYS_EOF found
-// EXAMPLE: endstr is ")", endstr_pair is "(", moving to odd endstr
-bool move_to_odd(GYS* s, string endstr, string endstr_pair)
+bool move_to_odd_cbracket(GYS* s)
+{
+	return s->move_to_odd(GYS_RBRACE, GYS_LBRACE);
+}
+
+//::::::::::::::::::::::::::::::::::::::::COMPILING::::::::::::::::::::::::::::::::::::::::
+// compiles the body till the odd "}" (like interp_to_odd_cbracket())
+// pf resumes the statement with args: stage, a1..a4, body state
+static bool compile_block(GYS_compiler* c, GYS_RESUME_FUNC_PTR pf, long stage, long a1=0, long a2=0, long a3=0, long a4=0)
 {
 	int more=1;
 
-	do
+	while(more)
 	{
-		s->get_token();		
+		long p=c->get_pos();
 
-		string cmp_to=s->get_tok_str();
+		if(c->get_tok_type(p)==GYS_EOF) // unexpected EOF (or wasn't read yet)
+			return false;
 
-		if(s->get_tok_type()==GYS_STRING)
+		if(c->get_tok_code(p)==GYS_RBRACE) // {} is possible
 		{
-			cmp_to="\""+cmp_to+"\"";
+			c->set_pos(p+1);
+			break;
 		}
-		else if(s->get_tok_type()==GYS_CHAR)
+
+		long code_pos=c->get_code_pos();
+
+		c->push_resume(pf, stage, a1, a2, a3, a4, body_state(more, true));
+		bool ok=c->compile_stmt();
+		if(ok && c->get_code_pos()!=code_pos)
+			c->emit_check_finished(); // e.g. after return
+		c->pop_resume();
+
+		if(!ok) // statement wasn't interpreted yet - it's interpreted when the code gets here
 		{
-			cmp_to="\'"+cmp_to+"\'";
+			c->set_code_pos(code_pos);
+
+			c->push_resume(pf, stage, a1, a2, a3, a4, body_state(more, false));
+			c->emit_leave(p);
+			c->pop_resume();
+
+			for(; more; more--) // move to odd "}"
+			{
+				p=c->find_odd(p, GYS_RBRACE, GYS_LBRACE);
+				if(p<0)
+					return false;
+			}
+
+			c->set_pos(p);
+			return true;
 		}
-		
-		if(s->get_tok_type()==GYS_DELIMETER && cmp_to==endstr_pair) 
-			more++; // we'll miss one endstr
-		else if(s->get_tok_type()==GYS_DELIMETER && cmp_to==endstr)
+
+		p=c->get_pos();
+
+		if(c->get_tok_code(p)==GYS_LBRACE) 
+		{
+			more++; // we'll miss one }
+			c->set_pos(p+1);
+		}
+		else if(c->get_tok_code(p)==GYS_RBRACE)
+		{
 			more--;
-	}	
-	while(s->get_tok_type()!=GYS_EOF && more);
+			c->set_pos(p+1);
+		}
+	}
 
-	if(s->get_tok_type()==GYS_EOF) // unexpected EOF
-		return false;
-	
 	return true;
 }
 
-// moves to the first unpaired odd "}" (curly)
-// returns false if GYS_EOF found
-bool move_to_odd_cbracket(GYS* s)
+// compiles code till end-delimeter (like interp_to())
+// pf resumes the statement with args: stage, a1..a4, 1
+static bool compile_to(GYS_compiler* c, GYS_delim end, GYS_RESUME_FUNC_PTR pf, long stage, long a1=0, long a2=0)
 {
-	return move_to_odd(s, "}", "{");
+	for(;;)
+	{
+		long p=c->get_pos();
+
+		if(c->get_tok_type(p)==GYS_EOF) // unexpected EOF (or wasn't read yet)
+			return false;
+
+		if(c->get_tok_code(p)==end) // end-delimeter found
+		{
+			c->set_pos(p+1);
+			return true;
+		}
+
+		long code_pos=c->get_code_pos();
+
+		c->push_resume(pf, stage, a1, a2, 0, 0, 1);
+		bool ok=c->compile_stmt();
+		if(ok && c->get_code_pos()!=code_pos)
+			c->emit_check_finished();
+		c->pop_resume();
+
+		if(!ok)
+			return false;
+	}
 }
 
 //::::::::::::::::::::::::::::::::::::::::MAIN::::::::::::::::::::::::::::::::::::::::
 // return statement
 GYS_ret_val exec_return(GYS* s)
 {
+	if(exec_tail_call(s))
+		return GYS_ret_val();
+
 	// read return value
 	s->set_ret_val(s->get_val(s->get_ret_type()).get_value());
 
@@ -147,35 +232,69 @@ GYS_ret_val exec_return(GYS* s)
 	return GYS_ret_val();
 }
 
-// if execution
-/*if(<bool>)
- {
-	...
- }
- [ else if(<bool>) [else if(<bool>) [else if(<bool>) ...]] { ... } ] 
- [else { ... }] 
-*/
-GYS_ret_val exec_if(GYS* s)
+// return value was read by the compiled code
+static GYS_ret_val resume_return(GYS* s, GYS_ret_val v, const long* args)
+{
+	s->set_ret_val(v.get_value());
+
+	s->finish_script();
+
+	return GYS_ret_val();
+}
+
+bool compile_return(GYS* s, GYS_compiler* c)
+{
+	if(c->is_tail_call()) // interpreted (exec_tail_call())
+		return false;
+
+	int r=c->new_reg();
+
+	c->push_resume(resume_return);
+	bool ok=c->compile_val(s->get_ret_type(), r);
+	c->pop_resume();
+
+	if(!ok)
+		return false;
+
+	c->emit_return(r);
+
+	return true;
+}
+
+// if execution from the stage
+static GYS_ret_val if_stmt(GYS* s, long stage, bool yes, bool exec_else, GYS_ret_val cond, long state)
 {	
-	bool yes=false;
-	bool exec_else=true;
+	bool new_condition=false;
+
+	switch(stage)
+	{
+	case STAGE_AFTER_COND:
+		new_condition=cond;
+		goto after_condition;
+	case STAGE_BODY:
+		goto body;
+	case STAGE_ELSE_BODY:
+		goto else_body;
+	}
 
 condition:
-	if(!s->exam("("))
+	if(!s->exam(GYS_LPAREN))
 		return GYS_ret_val();
 
-	bool new_condition=s->get_val(gys_bool_type);
+	new_condition=s->get_val(gys_bool_type);
+
+after_condition:
 	yes=(!yes && new_condition);
 
 	// there was some true condition -> no else execution
 	if(yes)
 		exec_else=false;
 
-	if(!s->exam(")"))
+	if(!s->exam(GYS_RPAREN))
 		return GYS_ret_val();
 
 	// body
-	if(!s->exam("{"))
+	if(!s->exam(GYS_LBRACE))
 		return GYS_ret_val();
 
 	// if FALSE just miss everything inside IF-body
@@ -189,7 +308,10 @@ condition:
 	}
 	else // do the body
 	{
-		if(!interp_to_odd_cbracket(s))
+		state=body_start;
+
+body:
+		if(!interp_body(s, state))
 		{
 			s->fatal_error("IF-statement: } wasn't found");
 			return GYS_ret_val();
@@ -210,7 +332,7 @@ condition:
 		else // no
 			s->putback_tok(); 
 
-		if(!s->exam("{"))
+		if(!s->exam(GYS_LBRACE))
 			return GYS_ret_val();
 
 		if(!exec_else) // just miss everything inside ELSE-body
@@ -223,7 +345,10 @@ condition:
 		}
 		else // exec the body
 		{
-			if(!interp_to_odd_cbracket(s))
+			state=body_start;
+
+else_body:
+			if(!interp_body(s, state))
 			{
 				s->fatal_error("IF-statement: } wasn't found");
 				return GYS_ret_val();
@@ -238,25 +363,210 @@ condition:
 	return GYS_ret_val();
 }
 
-// while(<bool>) {}
-GYS_ret_val exec_while(GYS* s)
+// args: stage, yes, exec_else, -, -, body state
+static GYS_ret_val resume_if(GYS* s, GYS_ret_val v, const long* args)
+{
+	return if_stmt(s, args[0], args[1]!=0, args[2]!=0, v, args[5]);
+}
+
+// if execution
+/*if(<bool>)
+ {
+	...
+ }
+ [ else if(<bool>) [else if(<bool>) [else if(<bool>) ...]] { ... } ] 
+ [else { ... }] 
+*/
+GYS_ret_val exec_if(GYS* s)
+{	
+	GYS_ret_val result;
+
+	if(s->exec_compiled(compile_if, result))
+		return result;
+
+	return if_stmt(s, STAGE_START, false, true, GYS_ret_val(), 0);
+}
+
+// conditions are compiled for every state: (previous condition was true, else is executed),
+// the bodies are compiled once
+bool compile_if(GYS* s, GYS_compiler* c)
+{
+	vector<long> conds, bodies; // "(" and "{" indices
+	long else_pos=-1, end=-1;
+
+	long p=c->get_pos();
+	for(;;)
+	{
+		if(c->get_tok_code(p)!=GYS_LPAREN)
+			return false;
+
+		long body_pos=c->find_odd(p+1, GYS_RPAREN, GYS_LPAREN);
+		if(body_pos<0 || c->get_tok_code(body_pos)!=GYS_LBRACE)
+			return false;
+
+		long body_end=c->find_odd(body_pos+1, GYS_RBRACE, GYS_LBRACE);
+		if(body_end<0 || c->get_tok_type(body_end)==GYS_EOF) // the token after the body must be read
+			return false;
+
+		conds.push_back(p);
+		bodies.push_back(body_pos);
+
+		end=body_end;
+
+		if(c->get_tok_type(body_end)==GYS_NAME && c->get_tok_str(body_end)=="else")
+		{
+			if(c->get_tok_type(body_end+1)==GYS_NAME && c->get_tok_str(body_end+1)=="if") // else if
+			{
+				p=body_end+2;
+				continue;
+			}
+
+			if(c->get_tok_code(body_end+1)!=GYS_LBRACE)
+				return false;
+
+			else_pos=body_end+1;
+
+			end=c->find_odd(else_pos+1, GYS_RBRACE, GYS_LBRACE);
+			if(end<0)
+				return false;
+		}
+
+		break;
+	}
+
+	int n=conds.size();
+	int r=c->new_reg();
+
+	int end_label=c->new_label();
+	int else_label= else_pos>=0 ? c->new_label() : end_label;
+
+	// states of the next condition: yes*2+exec_else
+	map<int, int> cur, next;
+	cur[1]=c->new_label(); // nothing was executed
+
+	for(int i=0; i<n; i++)
+	{
+		int body_label=-1;
+
+		for(map<int, int>::iterator it=cur.begin(); it!=cur.end(); it++)
+		{
+			bool yes=((*it).first & 2)!=0;
+			bool exec_else=((*it).first & 1)!=0;
+
+			c->set_label((*it).second);
+
+			// the next state's label
+			int next_state= yes ? 0 : (exec_else ? 1 : 0);
+			int next_label;
+
+			if(i+1==n)
+				next_label= (next_state & 1) ? else_label : end_label;
+			else
+			{
+				if(next.find(next_state)==next.end())
+					next[next_state]=c->new_label();
+				next_label=next[next_state];
+			}
+
+			long code_pos=c->get_code_pos();
+
+			c->set_pos(conds[i]+1);
+			c->push_resume(resume_if, STAGE_AFTER_COND, yes, exec_else);
+			bool ok=c->compile_val(gys_bool_type, r);
+			c->pop_resume();
+
+			if(ok && c->get_pos()!=bodies[i]-1) // ")" must follow the condition
+				return false;
+
+			if(!ok && !i) // the statement wasn't interpreted yet
+				return false;
+
+			if(!ok) // the condition wasn't interpreted yet
+			{
+				c->set_code_pos(code_pos);
+
+				c->push_resume(resume_if, STAGE_CONDITION, yes, exec_else);
+				c->emit_leave(conds[i]);
+				c->pop_resume();
+				continue;
+			}
+
+			if(!yes) // the body is executed if the condition is true
+			{
+				if(body_label<0)
+					body_label=c->new_label();
+
+				c->emit_jump_true(r, body_label);
+			}
+
+			c->emit_jump(next_label);
+		}
+
+		if(body_label>=0)
+		{
+			c->set_label(body_label);
+
+			c->set_pos(bodies[i]+1);
+			if(!compile_block(c, resume_if, STAGE_BODY, 1, 0))
+				return false;
+
+			// yes and no else execution
+			if(i+1==n)
+				c->emit_jump(end_label);
+			else
+			{
+				if(next.find(2)==next.end())
+					next[2]=c->new_label();
+				c->emit_jump(next[2]);
+			}
+		}
+
+		cur.swap(next);
+		next.clear();
+	}
+
+	if(else_pos>=0)
+	{
+		c->set_label(else_label);
+
+		c->set_pos(else_pos+1);
+		if(!compile_block(c, resume_if, STAGE_ELSE_BODY))
+			return false;
+	}
+
+	c->set_label(end_label);
+	c->set_pos(end);
+
+	return true;
+}
+
+// while-statement from the stage
+static GYS_ret_val while_stmt(GYS* s, long stage, long condition_pos, long old_line_num, GYS_ret_val cond, long state)
 {
-	long condition_pos=s->get_pos();
-	long old_line_num=s->get_line_num();
+	GYS_ret_val result;
 	bool yes=false;
 
+	if(stage==STAGE_AFTER_COND)
+	{
+		yes=cond;
+		goto after_condition;
+	}
+	else if(stage==STAGE_BODY)
+		goto body;
+
 condition:
 	// condition
-	if(!s->exam("("))
+	if(!s->exam(GYS_LPAREN))
 		return GYS_ret_val(); 
 		
 	yes=s->get_val(gys_bool_type);		
 
-	if(!s->exam(")"))
+after_condition:
+	if(!s->exam(GYS_RPAREN))
 		return GYS_ret_val(); 
 
 	// body
-	if(!s->exam("{"))
+	if(!s->exam(GYS_LBRACE))
 		return GYS_ret_val(); 
 
 	// if FALSE just miss everything inside WHILE-body
@@ -270,8 +580,11 @@ condition:
 	}
 	else
 	{
+		state=body_start;
+
+body:
 		// exec body code
-		if(!interp_to_odd_cbracket(s))
+		if(!interp_body(s, state))
 		{
 			s->fatal_error("WHILE-statement: } wasn't found");
 			return GYS_ret_val(); 
@@ -282,22 +595,92 @@ condition:
 		// next iteration - return back to the condition pos in this script
 		s->set_pos(condition_pos); // go back 
 		s->set_line_num(old_line_num); // correct linenum
+
+		if(s->exec_compiled(compile_while, result)) // the rest iterations
+			return result;
+
 		goto condition; // process new iteration
 	}
 	
 	return GYS_ret_val(); 
 }
 
-// do {...} while(<bool>)
-GYS_ret_val exec_do_while(GYS* s)
+// args: stage, condition pos, line num, -, -, body state
+static GYS_ret_val resume_while(GYS* s, GYS_ret_val v, const long* args)
+{
+	return while_stmt(s, args[0], args[1], args[2], v, args[5]);
+}
+
+// while(<bool>) {}
+GYS_ret_val exec_while(GYS* s)
 {
-	long body_pos=s->get_pos();
-	long body_line_num=s->get_line_num();
+	GYS_ret_val result;
+
+	if(s->exec_compiled(compile_while, result))
+		return result;
+
+	return while_stmt(s, STAGE_START, s->get_pos(), s->get_line_num(), GYS_ret_val(), 0);
+}
+
+// condition: jump after the body if false, body: jump to the condition
+bool compile_while(GYS* s, GYS_compiler* c)
+{
+	long condition_pos=c->get_pos();
+	long line=c->get_line_num(condition_pos-1);
+
+	if(c->get_tok_code(condition_pos)!=GYS_LPAREN)
+		return false;
+
+	int condition=c->new_label();
+	int end=c->new_label();
+	int r=c->new_reg();
+
+	c->set_label(condition);
+
+	c->set_pos(condition_pos+1);
+	c->push_resume(resume_while, STAGE_AFTER_COND, condition_pos, line);
+	bool ok=c->compile_val(gys_bool_type, r);
+	c->pop_resume();
+
+	long p=c->get_pos();
+	if(!ok || c->get_tok_code(p)!=GYS_RPAREN || c->get_tok_code(p+1)!=GYS_LBRACE)
+		return false;
+
+	long body_end=c->find_odd(p+2, GYS_RBRACE, GYS_LBRACE);
+	if(body_end<0)
+		return false;
+
+	c->emit_jump_false(r, end);
+
+	c->set_pos(p+2);
+	if(!compile_block(c, resume_while, STAGE_BODY, condition_pos, line) || c->get_pos()!=body_end)
+		return false;
+
+	c->emit_jump(condition);
+
+	c->set_label(end);
+	c->set_pos(body_end);
+
+	return true;
+}
+
+// do-while-statement from the stage
+static GYS_ret_val do_while_stmt(GYS* s, long stage, long body_pos, long body_line_num, GYS_ret_val cond, long state)
+{
+	GYS_ret_val result;
 	bool yes=true;
 
+	if(stage==STAGE_AFTER_COND)
+	{
+		yes=cond;
+		goto after_condition;
+	}
+	else if(stage==STAGE_BODY)
+		goto in_body;
+
 body:
 	// body
-	if(!s->exam("{"))
+	if(!s->exam(GYS_LBRACE))
 		return GYS_ret_val(); 
 
 	// if FALSE just miss everything inside WHILE-body
@@ -311,8 +694,11 @@ body:
 	}
 	else
 	{
+		state=body_start;
+
+in_body:
 		// exec body code
-		if(!interp_to_odd_cbracket(s))
+		if(!interp_body(s, state))
 		{
 			s->fatal_error("DO-WHILE-statement: } wasn't found");
 			return GYS_ret_val(); 
@@ -326,12 +712,13 @@ body:
 	if(!s->exam("while"))
 		return GYS_ret_val(); 
 
-	if(!s->exam("("))
+	if(!s->exam(GYS_LPAREN))
 		return GYS_ret_val(); 
 		
 	yes=s->get_val(gys_bool_type);		
 
-	if(!s->exam(")"))
+after_condition:
+	if(!s->exam(GYS_RPAREN))
 		return GYS_ret_val(); 
 
 	if(yes)
@@ -339,20 +726,100 @@ body:
 		// next iteration - return back to the body pos in this script
 		s->set_pos(body_pos); // go back 
 		s->set_line_num(body_line_num); // correct linenum
+
+		if(s->exec_compiled(compile_do_while, result)) // the rest iterations
+			return result;
+
 		goto body; // process new iteration
 	}
 
 	return GYS_ret_val(); 
 }
 
-// for([<init-code>];[<bool-condition>];[<loop-code>]) {...}
-GYS_ret_val exec_for(GYS* s)
+// args: stage, body pos, line num, -, -, body state
+static GYS_ret_val resume_do_while(GYS* s, GYS_ret_val v, const long* args)
+{
+	return do_while_stmt(s, args[0], args[1], args[2], v, args[5]);
+}
+
+// do {...} while(<bool>)
+GYS_ret_val exec_do_while(GYS* s)
+{
+	GYS_ret_val result;
+
+	if(s->exec_compiled(compile_do_while, result))
+		return result;
+
+	return do_while_stmt(s, STAGE_START, s->get_pos(), s->get_line_num(), GYS_ret_val(), 0);
+}
+
+// body, condition: jump to the body if true
+bool compile_do_while(GYS* s, GYS_compiler* c)
 {
-	if(!s->exam("("))
+	long body_pos=c->get_pos();
+	long line=c->get_line_num(body_pos-1);
+
+	if(c->get_tok_code(body_pos)!=GYS_LBRACE)
+		return false;
+
+	int body=c->new_label();
+	int r=c->new_reg();
+
+	c->set_label(body);
+
+	c->set_pos(body_pos+1);
+	if(!compile_block(c, resume_do_while, STAGE_BODY, body_pos, line))
+		return false;
+
+	long p=c->get_pos();
+	if(c->get_tok_type(p)!=GYS_NAME || c->get_tok_str(p)!="while" || c->get_tok_code(p+1)!=GYS_LPAREN)
+		return false;
+
+	c->set_pos(p+2);
+	c->push_resume(resume_do_while, STAGE_AFTER_COND, body_pos, line);
+	bool ok=c->compile_val(gys_bool_type, r);
+	c->pop_resume();
+
+	p=c->get_pos();
+	if(!ok || c->get_tok_code(p)!=GYS_RPAREN)
+		return false;
+
+	c->emit_jump_true(r, body);
+
+	c->set_pos(p+1);
+
+	return true;
+}
+
+// for-statement from the stage
+static GYS_ret_val for_stmt(GYS* s, long stage, long cond_pos, long cond_line_num, long loop_pos, long loop_line_num, GYS_ret_val cond, long state)
+{
+	GYS_ret_val result;
+	bool yes=true;
+
+	switch(stage)
+	{
+	case STAGE_INIT:
+		goto init;
+	case STAGE_CONDITION:
+		goto condition;
+	case STAGE_AFTER_COND:
+		yes=cond;
+		goto after_condition;
+	case STAGE_BODY:
+		goto body;
+	case STAGE_LOOP_CODE:
+		goto loop_code;
+	}
+
+	if(!s->exam(GYS_LPAREN))
 		return GYS_ret_val(); 
 
+	state=0;
+
+init:
 	// interp init-code
-	if(!interp_to(s, ";"))
+	if(!interp_to(s, GYS_SEMICOLON, state!=0))
 	{
 		s->fatal_error("FOR-statement(init-code): ';' wasn't found");
 		return GYS_ret_val(); 
@@ -362,32 +829,33 @@ GYS_ret_val exec_for(GYS* s)
 
 condition:
 	// read condition
-	long cond_pos=s->get_pos();
-	long cond_line_num=s->get_line_num();
-	bool yes=true;
+	cond_pos=s->get_pos();
+	cond_line_num=s->get_line_num();
+	yes=true;
 
 	s->get_token();
-	if( !(s->get_tok_type()==GYS_DELIMETER && s->get_tok_str()==";") ) // e.g. for(xxx;;yyy)
+	if(s->get_tok_code()!=GYS_SEMICOLON) // e.g. for(xxx;;yyy)
 	{
 		s->putback_tok();
 		yes=s->get_val(gys_bool_type);
 
-		if(!s->exam(";"))
+after_condition:
+		if(!s->exam(GYS_SEMICOLON))
 			return GYS_ret_val(); 
 	}
 	
 	// miss loop-code
-	long loop_pos=s->get_pos();
-	long loop_line_num=s->get_line_num();
+	loop_pos=s->get_pos();
+	loop_line_num=s->get_line_num();
 
-	if(!move_to_odd(s, ")", "("))
+	if(!s->move_to_odd(GYS_RPAREN, GYS_LPAREN))
 	{
 		s->fatal_error("FOR-statement(loop-code reading): ')' wasn't found");
 		return GYS_ret_val(); 
 	}
 	
 	// body
-	if(!s->exam("{"))
+	if(!s->exam(GYS_LBRACE))
 		return GYS_ret_val(); 
 
 	if(!yes) // miss body if FALSE
@@ -400,8 +868,11 @@ condition:
 	}
 	else // interp body and next iteration
 	{
+		state=body_start;
+
+body:
 		// exec body code
-		if(!interp_to_odd_cbracket(s))
+		if(!interp_body(s, state))
 		{
 			s->fatal_error("FOR-statement: } wasn't found");
 			return GYS_ret_val(); 
@@ -415,7 +886,10 @@ condition:
 		s->set_pos(loop_pos); // go back 
 		s->set_line_num(loop_line_num); // correct linenum
 
-		if(!interp_to(s, ")"))
+		state=0;
+
+loop_code:
+		if(!interp_to(s, GYS_RPAREN, state!=0))
 		{	
 			s->fatal_error("FOR-statement(loop-code interpreting): ')' wasn't found");
 			return GYS_ret_val(); 
@@ -424,12 +898,104 @@ condition:
 		// return back to the condition pos in this script
 		s->set_pos(cond_pos); // go back 
 		s->set_line_num(cond_line_num); // correct linenum
+
+		if(s->exec_compiled(compile_for_loop, result)) // the rest iterations
+			return result;
+
 		goto condition; // process new iteration
 	}
 
 	return GYS_ret_val(); 
 }
 
+// args: stage, condition pos, its line num, loop-code pos, its line num, body state (1 - after statement in other stages)
+static GYS_ret_val resume_for(GYS* s, GYS_ret_val v, const long* args)
+{
+	return for_stmt(s, args[0], args[1], args[2], args[3], args[4], v, args[5]);
+}
+
+// for([<init-code>];[<bool-condition>];[<loop-code>]) {...}
+GYS_ret_val exec_for(GYS* s)
+{
+	GYS_ret_val result;
+
+	if(s->exec_compiled(compile_for, result))
+		return result;
+
+	return for_stmt(s, STAGE_START, 0, 0, 0, 0, GYS_ret_val(), 0);
+}
+
+// init-code and the loop
+bool compile_for(GYS* s, GYS_compiler* c)
+{
+	long p=c->get_pos();
+
+	if(c->get_tok_code(p)!=GYS_LPAREN)
+		return false;
+
+	c->set_pos(p+1);
+	if(!compile_to(c, GYS_SEMICOLON, resume_for, STAGE_INIT))
+		return false;
+
+	return compile_for_loop(s, c);
+}
+
+// from the condition: jump after the body if false, body, loop-code, jump to the condition
+bool compile_for_loop(GYS* s, GYS_compiler* c)
+{
+	long cond_pos=c->get_pos();
+	long cond_line=c->get_line_num(cond_pos-1);
+
+	int condition=c->new_label();
+	int end=c->new_label();
+	int r=-1;
+
+	c->set_label(condition);
+
+	long p=cond_pos;
+	if(c->get_tok_code(p)!=GYS_SEMICOLON) // e.g. for(xxx;;yyy)
+	{
+		r=c->new_reg();
+
+		c->push_resume(resume_for, STAGE_AFTER_COND, cond_pos, cond_line);
+		bool ok=c->compile_val(gys_bool_type, r);
+		c->pop_resume();
+
+		p=c->get_pos();
+		if(!ok || c->get_tok_code(p)!=GYS_SEMICOLON)
+			return false;
+	}
+
+	long loop_pos=p+1;
+	long loop_line=c->get_line_num(p);
+
+	long body_pos=c->find_odd(loop_pos, GYS_RPAREN, GYS_LPAREN);
+	if(body_pos<0 || c->get_tok_code(body_pos)!=GYS_LBRACE)
+		return false;
+
+	long body_end=c->find_odd(body_pos+1, GYS_RBRACE, GYS_LBRACE);
+	if(body_end<0)
+		return false;
+
+	if(r>=0)
+		c->emit_jump_false(r, end);
+
+	c->set_pos(body_pos+1);
+	if(!compile_block(c, resume_for, STAGE_BODY, cond_pos, cond_line, loop_pos, loop_line) || c->get_pos()!=body_end)
+		return false;
+
+	c->set_pos(loop_pos);
+	if(!compile_to(c, GYS_RPAREN, resume_for, STAGE_LOOP_CODE, cond_pos, cond_line) || c->get_pos()!=body_pos)
+		return false;
+
+	c->emit_jump(condition);
+
+	c->set_label(end);
+	c->set_pos(body_end);
+
+	return true;
+}
+
 void add_statements(GYS* script)
 {
 	script->add_gys_func("return", exec_return); 
@@ -437,4 +1003,10 @@ void add_statements(GYS* script)
 	script->add_gys_func("while",  exec_while); 
 	script->add_gys_func("do",     exec_do_while); 
 	script->add_gys_func("for",    exec_for); 
+
+	script->add_gys_func_compiler("return", compile_return); 
+	script->add_gys_func_compiler("if",     compile_if); 
+	script->add_gys_func_compiler("while",  compile_while); 
+	script->add_gys_func_compiler("do",     compile_do_while); 
+	script->add_gys_func_compiler("for",    compile_for); 
 }
@@ -46,4 +46,12 @@ GYS_ret_val exec_do_while(GYS* script);
 // void for(<code>; <bool-condition>; <code>) {...} - loop
 GYS_ret_val exec_for(GYS* script);
 
+// compilers of the statements (GYS_COMPILE mode)
+bool compile_return(GYS* script, GYS_compiler* c);
+bool compile_if(GYS* script, GYS_compiler* c);
+bool compile_while(GYS* script, GYS_compiler* c);
+bool compile_do_while(GYS* script, GYS_compiler* c);
+bool compile_for(GYS* script, GYS_compiler* c);
+bool compile_for_loop(GYS* script, GYS_compiler* c); // from the condition
+
 #endif
\ No newline at end of file
@@ -108,6 +108,30 @@ GYS_ret_val op_mul_assign_str(GYS* script, GYS_ret_val l, GYS_ret_val r)
 	return s;
 }
 
+// string+=string - appends in place if the variable is the only owner of its string
+GYS_ret_val op_add_assign_str(GYS* script, GYS_ret_val l, GYS_ret_val r)
+{
+	if(!l.is_lvalue())
+	{
+		script->error("'"+l.get_type_name()+"' += '"+r.get_type_name()+"' : left operand must be lvalue.");
+		return (string)l;
+	}
+
+	static const GYS_type_id string_id=gys_type_id(gys_string_type);
+
+	GYS_user_val* owner=l.get_ptr_to_user_val();
+	string* s=l;
+	string* tail=r;
+
+	if(owner && owner->getRefCnt()==1 && l.get_type_id()==string_id && tail) // copies don't see the change
+	{
+		s->append(*tail); // s+=s is possible
+		return l;
+	}
+
+	return l=(string)l+(string)r;
+}
+
 // string[int]
 GYS_ret_val op_index_str(GYS* script, GYS_ret_val l, GYS_ret_val r)
 {
@@ -134,7 +158,7 @@ void add_string_type(GYS* s)
 	s->add_binary_op("*", gys_string_type, gys_int_type,    op_mul_str);
 
 	s->add_binary_op("*=", gys_string_type, gys_int_type,    op_mul_assign_str);
-	s->add_binary_op("+=", gys_string_type, gys_string_type, op_add_assign<string, string, string>);
+	s->add_binary_op("+=", gys_string_type, gys_string_type, op_add_assign_str);
 
 	s->add_binary_op("==", gys_string_type, gys_string_type, op_equal<string, string, bool>);
 	s->add_binary_op("!=", gys_string_type, gys_string_type, op_not_equal<string, string, bool>);
@@ -43,6 +43,11 @@ public:
 		return gys_string_type;
 	}		
 
+	GYS_type_id get_type_id() const {
+		static const GYS_type_id id=gys_type_id(gys_string_type);
+		return id;
+	}
+
 	void* get_user_val() {
 		return &val;
 	}
@@ -46,6 +46,7 @@
 #include "gys_string_type.h"
 #include "gys_vector_type.h"
 #include "gys_function_type.h"
+#include "gys_matrix_type.h"
 
 #include "gys_converters.h"
 
@@ -78,7 +79,7 @@ new_ext_var:
 	if(!s->exam("="))
 		return GYS_ret_val();
 
-	if( ( val=s->get_val( type ) ).get_type_name()!=gys_void_type ) // not void
+	if( ( val=s->get_val( type ) ).get_type_id()!=gys_void_type_id ) // not void
 		s->add_global_var(name, val.get_value());
 	
 	s->get_token();
@@ -102,6 +103,7 @@ void add_stdgys_types(GYS* s)
 	add_string_type(s);
 	add_vector_type(s);
 	add_function_type(s);
+	add_matrix_type(s);
 
 	add_converters(s);
 }
\ No newline at end of file
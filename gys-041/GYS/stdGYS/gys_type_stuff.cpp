@@ -59,7 +59,7 @@ new_var:
 	if(!s->exam("="))
 		return GYS_ret_val();
 
-	if( ( val=s->get_val( type ) ).get_type_name()!=gys_void_type ) // not VOID
+	if( ( val=s->get_val( type ) ).get_type_id()!=gys_void_type_id ) // not VOID
 		s->add_local_var(name, val.get_value());
 	
 	s->get_token();
@@ -320,4 +320,17 @@ template<class Left> GYS_ret_val op_post_dec(GYS* script, GYS_ret_val l)
 	l=(Left)l-1;
 
 	return l_original;
+}
+
+//--------------------------------------------QUICK OPERATORS--------------------------------------------
+//! quick form of binary operator Op: the right operand of type Right is converted into Conv without GYS-conversion (see GYS::add_quick_binary_op())
+template<class Right, class Conv, GYS_BINARY_OP_FUNC_PTR Op> GYS_ret_val op_quick(GYS* script, GYS_ret_val l, GYS_ret_val r)
+{
+	return Op(script, l, (Conv)(Right)r);
+}
+
+//! quick form of universal = (op_assign is static and can't be a template argument)
+template<class Right, class Conv> GYS_ret_val op_quick_assign(GYS* script, GYS_ret_val l, GYS_ret_val r)
+{
+	return op_assign(script, l, (Conv)(Right)r);
 }
\ No newline at end of file
@@ -61,7 +61,7 @@ GYS_ret_val exec_size(GYS* script)
 			
 	script->exam(")");	
 
-	return (int) (vec.get_vector().size());
+	return (int) vec.size();
 }
 
 GYS_ret_val exec_empty(GYS* script)
@@ -72,7 +72,7 @@ GYS_ret_val exec_empty(GYS* script)
 
 	script->exam(")");	
 
-	return (bool) vec.get_vector().empty();
+	return (bool) vec.empty();
 }
 
 GYS_ret_val exec_front(GYS* script)
@@ -83,8 +83,8 @@ GYS_ret_val exec_front(GYS* script)
 
 	script->exam(")");	
 
-	if( !(vec.get_vector().empty()) )
-		return vec.get_vector().front();
+	if( !vec.empty() )
+		return vec.at(0);
 	else
 		script->error("front(): vector is empty");
 			
@@ -99,8 +99,8 @@ GYS_ret_val exec_back(GYS* script)
 
 	script->exam(")");	
 
-	if( !(vec.get_vector().empty()) )
-		return vec.get_vector().back();
+	if( !vec.empty() )
+		return vec.at(vec.size()-1);
 	else
 		script->error("back(): vector is empty");
 			
@@ -212,6 +212,178 @@ GYS_ret_val exec_clear(GYS* script)
 	return (GYS_vector_val)vec;
 }
 
+// argument of element-wise operation (scalar is converted into vector of one element)
+static GYS_vector_val get_elementwise_arg(GYS* script, const string& name)
+{
+	static const GYS_type_id int_id=gys_type_id(gys_int_type);
+	static const GYS_type_id double_id=gys_type_id(gys_vector_double_type);
+	static const GYS_type_id vector_id=gys_type_id(gys_vector_type);
+
+	// "raw" numbers are read as double, #type{...} - as vector
+	script->get_token();
+	bool vector_data= script->get_tok_type()==GYS_DELIMETER && script->get_tok_str()=="#";
+	script->putback_tok();
+
+	GYS_ret_val arg=script->get_any_val(vector_data ? gys_vector_type : gys_vector_double_type);
+	GYS_type_id type=arg.get_type_id();
+
+	if(type==int_id)
+		arg=gys_vector_double_val((int)arg);
+	else if(type!=double_id && type!=vector_id)
+	{
+		if(type!=gys_void_type_id) // void is reported by the expression
+			script->error(name+"(): vector, 'int' or 'double' expected instead of ", arg.get_type_name());
+
+		return GYS_vector_val();
+	}
+
+	return script->exec_converter(arg, gys_vector_type);
+}
+
+// element-wise operation of int or double vectors
+static GYS_ret_val exec_elementwise(GYS* script, GYS_vector_op op, const string& name)
+{
+	script->exam("(");
+
+	GYS_vector_val l=get_elementwise_arg(script, name);
+
+	script->exam(",");
+
+	GYS_vector_val r=get_elementwise_arg(script, name);
+
+	script->exam(")");
+
+	if(l.size()!=r.size() && l.size()!=1 && r.size()!=1)
+	{
+		script->error(name+"(): sizes of vectors differ");
+		return GYS_ret_val();
+	}
+
+	GYS_vector_val result;
+	if(!l.elementwise(op, r, result))
+	{
+		if(!l.is_numeric() || !r.is_numeric())
+			script->error(name+"(): vectors of 'int' or 'double' expected");
+		else // the sizes are checked above
+			script->error(name+"(): divisor can't be 0");
+
+		return GYS_ret_val();
+	}
+
+	return result;
+}
+
+GYS_ret_val exec_vadd(GYS* script)        { return exec_elementwise(script, GYS_VECTOR_ADD, "vadd"); }
+GYS_ret_val exec_vsub(GYS* script)        { return exec_elementwise(script, GYS_VECTOR_SUB, "vsub"); }
+GYS_ret_val exec_vmul(GYS* script)        { return exec_elementwise(script, GYS_VECTOR_MUL, "vmul"); }
+GYS_ret_val exec_vdiv(GYS* script)        { return exec_elementwise(script, GYS_VECTOR_DIV, "vdiv"); }
+GYS_ret_val exec_vless(GYS* script)       { return exec_elementwise(script, GYS_VECTOR_LESS, "vless"); }
+GYS_ret_val exec_vgreater(GYS* script)    { return exec_elementwise(script, GYS_VECTOR_GREATER, "vgreater"); }
+GYS_ret_val exec_vless_eq(GYS* script)    { return exec_elementwise(script, GYS_VECTOR_LESS_EQ, "vless_eq"); }
+GYS_ret_val exec_vgreater_eq(GYS* script) { return exec_elementwise(script, GYS_VECTOR_GREATER_EQ, "vgreater_eq"); }
+GYS_ret_val exec_vequal(GYS* script)      { return exec_elementwise(script, GYS_VECTOR_EQUAL, "vequal"); }
+GYS_ret_val exec_vnot_equal(GYS* script)  { return exec_elementwise(script, GYS_VECTOR_NOT_EQUAL, "vnot_equal"); }
+
+// reduction of int or double vector
+static bool get_reduction(GYS* script, GYS_vector_reduction op, const string& name, GYS_vector_val& vec, double& result)
+{
+	script->exam("(");
+
+	vec=script->get_val(gys_vector_type);
+
+	script->exam(")");
+
+	if(!vec.reduce(op, result))
+	{
+		if(!vec.is_numeric())
+			script->error(name+"(): vector of 'int' or 'double' expected");
+		else // only the sum of no elements is defined
+			script->error(name+"(): vector can't be empty");
+
+		return false;
+	}
+
+	return true;
+}
+
+GYS_ret_val exec_vsum(GYS* script)
+{
+	GYS_vector_val vec;
+	double sum;
+
+	return get_reduction(script, GYS_VECTOR_SUM, "vsum", vec, sum) ? gys_vector_double_val(sum) : GYS_ret_val();
+}
+
+GYS_ret_val exec_vmean(GYS* script)
+{
+	GYS_vector_val vec;
+	double mean;
+
+	return get_reduction(script, GYS_VECTOR_MEAN, "vmean", vec, mean) ? gys_vector_double_val(mean) : GYS_ret_val();
+}
+
+GYS_ret_val exec_vvariance(GYS* script)
+{
+	GYS_vector_val vec;
+	double variance;
+
+	return get_reduction(script, GYS_VECTOR_VARIANCE, "vvariance", vec, variance) ? gys_vector_double_val(variance) : GYS_ret_val();
+}
+
+GYS_ret_val exec_vmin(GYS* script)
+{
+	GYS_vector_val vec;
+	double index;
+
+	return get_reduction(script, GYS_VECTOR_ARGMIN, "vmin", vec, index) ? vec.at((unsigned)index) : GYS_ret_val();
+}
+
+GYS_ret_val exec_vmax(GYS* script)
+{
+	GYS_vector_val vec;
+	double index;
+
+	return get_reduction(script, GYS_VECTOR_ARGMAX, "vmax", vec, index) ? vec.at((unsigned)index) : GYS_ret_val();
+}
+
+GYS_ret_val exec_vargmin(GYS* script)
+{
+	GYS_vector_val vec;
+	double index;
+
+	return get_reduction(script, GYS_VECTOR_ARGMIN, "vargmin", vec, index) ? GYS_ret_val((int)index) : GYS_ret_val();
+}
+
+GYS_ret_val exec_vargmax(GYS* script)
+{
+	GYS_vector_val vec;
+	double index;
+
+	return get_reduction(script, GYS_VECTOR_ARGMAX, "vargmax", vec, index) ? GYS_ret_val((int)index) : GYS_ret_val();
+}
+
+GYS_ret_val exec_vdot(GYS* script)
+{
+	script->exam("(");
+
+	GYS_vector_val l=script->get_val(gys_vector_type);
+
+	script->exam(",");
+
+	GYS_vector_val r=script->get_val(gys_vector_type);
+
+	script->exam(")");
+
+	double result;
+	if(!l.dot(r, result))
+	{
+		script->error("vdot(): vectors of 'int' or 'double' of the same size expected");
+		return GYS_ret_val();
+	}
+
+	return gys_vector_double_val(result);
+}
+
 void add_vector_funcs(GYS* script)
 {
 	script->add_gys_func("make_vector", exec_make_vector);
@@ -227,4 +399,39 @@ void add_vector_funcs(GYS* script)
 	script->add_gys_func("insert",    exec_insert);
 	script->add_gys_func("erase",     exec_erase);
 	script->add_gys_func("clear",     exec_clear);
+
+	script->add_gys_func("vadd", exec_vadd);
+	script->add_gys_func("vsub", exec_vsub);
+	script->add_gys_func("vmul", exec_vmul);
+	script->add_gys_func("vdiv", exec_vdiv);
+
+	script->add_gys_func("vless",       exec_vless);
+	script->add_gys_func("vgreater",    exec_vgreater);
+	script->add_gys_func("vless_eq",    exec_vless_eq);
+	script->add_gys_func("vgreater_eq", exec_vgreater_eq);
+	script->add_gys_func("vequal",      exec_vequal);
+	script->add_gys_func("vnot_equal",  exec_vnot_equal);
+
+	script->add_gys_func("vsum",      exec_vsum);
+	script->add_gys_func("vmean",     exec_vmean);
+	script->add_gys_func("vvariance", exec_vvariance);
+	script->add_gys_func("vmin",      exec_vmin);
+	script->add_gys_func("vmax",      exec_vmax);
+	script->add_gys_func("vargmin",   exec_vargmin);
+	script->add_gys_func("vargmax",   exec_vargmax);
+	script->add_gys_func("vdot",      exec_vdot);
+
+	// results depend only on the arguments (see GYS_OPT_HOIST)
+	script->add_pure_gys_func("content_type");
+	script->add_pure_gys_func("size");
+	script->add_pure_gys_func("empty");
+	script->add_pure_gys_func("front");
+	script->add_pure_gys_func("back");
+
+	const char* pure[]={ "vadd", "vsub", "vmul", "vdiv",
+		"vless", "vgreater", "vless_eq", "vgreater_eq", "vequal", "vnot_equal",
+		"vsum", "vmean", "vvariance", "vmin", "vmax", "vargmin", "vargmax", "vdot" };
+
+	for(unsigned i=0;i<sizeof(pure)/sizeof(pure[0]);i++)
+		script->add_pure_gys_func(pure[i]);
 }
\ No newline at end of file
@@ -45,4 +45,26 @@ GYS_ret_val exec_insert(GYS* script);    // vector insert(<vector>, <int>, <some
 GYS_ret_val exec_erase(GYS* script);     // vector erase(<vector>, <int>)
 GYS_ret_val exec_clear(GYS* script);     // vector clear(<vector>)
 
+// element-wise operations of int or double vectors (vector of one element is broadcast)
+GYS_ret_val exec_vadd(GYS* script);        // vector vadd(<vector>, <vector>) - vector of double
+GYS_ret_val exec_vsub(GYS* script);        // vector vsub(<vector>, <vector>) - vector of double
+GYS_ret_val exec_vmul(GYS* script);        // vector vmul(<vector>, <vector>) - vector of double
+GYS_ret_val exec_vdiv(GYS* script);        // vector vdiv(<vector>, <vector>) - vector of double
+GYS_ret_val exec_vless(GYS* script);       // vector vless(<vector>, <vector>) - vector of bool
+GYS_ret_val exec_vgreater(GYS* script);    // vector vgreater(<vector>, <vector>) - vector of bool
+GYS_ret_val exec_vless_eq(GYS* script);    // vector vless_eq(<vector>, <vector>) - vector of bool
+GYS_ret_val exec_vgreater_eq(GYS* script); // vector vgreater_eq(<vector>, <vector>) - vector of bool
+GYS_ret_val exec_vequal(GYS* script);      // vector vequal(<vector>, <vector>) - vector of bool
+GYS_ret_val exec_vnot_equal(GYS* script);  // vector vnot_equal(<vector>, <vector>) - vector of bool
+
+// reductions of int or double vectors (sums are computed pairwise)
+GYS_ret_val exec_vsum(GYS* script);      // double vsum(<vector>)
+GYS_ret_val exec_vmean(GYS* script);     // double vmean(<vector>)
+GYS_ret_val exec_vvariance(GYS* script); // double vvariance(<vector>) - population variance
+GYS_ret_val exec_vmin(GYS* script);      // some_type vmin(<vector>)
+GYS_ret_val exec_vmax(GYS* script);      // some_type vmax(<vector>)
+GYS_ret_val exec_vargmin(GYS* script);   // int vargmin(<vector>) - index of the first minimum
+GYS_ret_val exec_vargmax(GYS* script);   // int vargmax(<vector>) - index of the first maximum
+GYS_ret_val exec_vdot(GYS* script);      // double vdot(<vector>, <vector>)
+
 #endif
\ No newline at end of file
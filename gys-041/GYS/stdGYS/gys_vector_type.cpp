@@ -44,9 +44,18 @@ public:
 		return gys_vector_type;
 	}		
 
+	GYS_type_id get_type_id() const {
+		static const GYS_type_id id=gys_type_id(gys_vector_type);
+		return id;
+	}
+
 	void* get_user_val() {
 		return &val;
 	}
+
+	bool shares_values() const {
+		return val.shares_values();
+	}
 };
 
 GYS_ret_val& store(GYS_ret_val& val, GYS_vector_val vector_user_val)
@@ -133,29 +142,31 @@ GYS_ret_val get_vector_val(GYS* s)
 // vector[int] - returns lvalue if vector is lvalue
 GYS_ret_val op_index_vector(GYS* script, GYS_ret_val l, GYS_ret_val r)
 {
-	GYS_ret_val* v=(*(GYS_vector_val*)l )[ (int)r ];
+	GYS_vector_val* vec=l;
+	int index=r;
 	
-	if(!v) // error
+	if(index<0 || (unsigned)index>=vec->size()) // error
 	{
 		script->error((string)gys_vector_type+"[]: invalid index");
 		return GYS_ret_val();
 	}
 
-	return l.is_lvalue() ? v : *v;
+	// only the elements of lvalue can be changed (they're unshared when they are changed)
+	return l.is_lvalue() ? vec->get_lvalue(index) : vec->at(index);
 }
 
 // vector+vector
 GYS_ret_val op_add_vector(GYS* script, GYS_ret_val l, GYS_ret_val r)
 {
-	GYS_ret_val t=(GYS_vector_val)l; // temp
+	GYS_vector_val t=l; // shares the elements of l till the first push_back()
 
 	// push all elements from r into t with conversion
 	if((GYS_vector_val*)r)
 	{
-		unsigned r_size=((GYS_vector_val)r).get_vector().size();
+		GYS_vector_val rvec=r;
+		unsigned r_size=rvec.size();
 		for(unsigned i=0; i<r_size; i++)
-			if(! (*(GYS_vector_val*)t ).
-push_back( script->exec_converter(*((GYS_vector_val)r)[i], ((GYS_vector_val)l).get_type_name()) ) )
+			if(! t.push_back( script->exec_converter(rvec.at(i), t.get_type_id()) ) )
 				script->error("'"+(string)gys_vector_type+"' + '"+gys_vector_type+"' : can't add new element.");
 	}
 
@@ -174,17 +185,17 @@ GYS_ret_val op_add_assign_vector(GYS* script, GYS_ret_val l, GYS_ret_val r)
 	// push all elements from r into l with conversion
 	if((GYS_vector_val*)r)
 	{
-		unsigned r_size=((GYS_vector_val)r).get_vector().size(); // avoids endless loop (consider this example: vec_var+=vec_var)
+		GYS_vector_val rvec=r; // keeps the elements of r (consider this example: vec_var+=vec_var)
+		unsigned r_size=rvec.size();
 		for(unsigned i=0; i<r_size; i++)
-			if(! (*(GYS_vector_val*)l ).
-push_back( script->exec_converter(((GYS_vector_val)r)[i]->get_value(), ((GYS_vector_val)l).get_type_name()) ) )
+			if(! (*(GYS_vector_val*)l ).push_back( script->exec_converter(rvec.at(i), ((GYS_vector_val*)l)->get_type_id()) ) )
 				script->error("'"+(string)gys_vector_type+"' += '"+gys_vector_type+"' : can't add new element.");
 	}
 
 	return l;
 }
 
-// range op vector(low~up) - returns elements as new non-lvalue vector [low; up]
+// range op vector(low~up) - returns elements [low; up] as non-lvalue slice of vector
 GYS_ret_val op_post_range_vector(GYS* script, GYS_ret_val l)
 {
 	int low=script->get_val(gys_int_type);
@@ -204,24 +215,19 @@ GYS_ret_val op_post_range_vector(GYS* script, GYS_ret_val l)
 		return GYS_ret_val();
 	}
 
-	if(!vec[low])
+	if(low<0 || (unsigned)low>=vec.size())
 	{
 		script->error("'"+(string)gys_vector_type+"' (int~int) : invalid lower index.");
 		return GYS_ret_val();
 	}
 
-	if(!vec[up])
+	if((unsigned)up>=vec.size())
 	{
 		script->error("'"+(string)gys_vector_type+"' (int~int) : invalid upper index.");
 		return GYS_ret_val();
 	}
 
-	GYS_vector_val out_vec(vec.get_type_name());
-
-	for(int i=low;i<=up;i++)
-		out_vec.push_back(*vec[i]);
-
-	return out_vec;
+	return vec.slice(low, up-low+1); // refers to the elements of vec
 }
 
 void add_vector_type(GYS* s)
@@ -239,23 +245,434 @@ void add_vector_type(GYS* s)
 }
 
 //--------------------------GYS vector value-------------------------------
-GYS_vector_val::GYS_vector_val(string vtype) : val_type(vtype) {}
+GYS_ret_val gys_vector_double_val(double d)
+{
+	static const GYS_type_id double_id=gys_type_id(gys_vector_double_type);
+
+	GYS_ret_val v;
+	v.set_small_val(d, double_id);
+	return v;
+}
+
+// storage of the elements of the type
+static GYS_vector_storage vector_storage(GYS_type_id type)
+{
+	static const GYS_type_id bool_id=gys_type_id(gys_vector_bool_type);
+	static const GYS_type_id char_id=gys_type_id(gys_vector_char_type);
+	static const GYS_type_id int_id=gys_type_id(gys_int_type);
+	static const GYS_type_id double_id=gys_type_id(gys_vector_double_type);
+
+	if(type==bool_id)
+		return GYS_VECTOR_BOOL;
+	else if(type==char_id)
+		return GYS_VECTOR_CHAR;
+	else if(type==int_id)
+		return GYS_VECTOR_INT;
+	else if(type==double_id)
+		return GYS_VECTOR_DOUBLE;
+
+	return GYS_VECTOR_BOXED;
+}
+
+static unsigned vector_size(const GYS_vector_data& d)
+{
+	switch(d.kind)
+	{
+	case GYS_VECTOR_BOOL:
+	case GYS_VECTOR_CHAR:   return d.chars.size();
+	case GYS_VECTOR_INT:    return d.ints.size();
+	case GYS_VECTOR_DOUBLE: return d.doubles.size();
+	default:                return d.vec.size();
+	}
+}
+
+// value of the element i (unboxed one gets small value)
+static GYS_ret_val vector_elem(const GYS_vector_data& d, unsigned i, GYS_type_id type)
+{
+	GYS_ret_val v;
+
+	switch(d.kind)
+	{
+	case GYS_VECTOR_BOOL:   v.set_small_val(d.chars[i]!=0, type); break;
+	case GYS_VECTOR_CHAR:   v.set_small_val(d.chars[i], type);    break;
+	case GYS_VECTOR_INT:    v.set_small_val(d.ints[i], type);     break;
+	case GYS_VECTOR_DOUBLE: v.set_small_val(d.doubles[i], type);  break;
+	default:                v=d.vec[i];
+	}
+
+	return v;
+}
+
+// inserts n elements (=v) before the element pos
+static void vector_insert(GYS_vector_data& d, unsigned pos, unsigned n, GYS_ret_val v)
+{
+	switch(d.kind)
+	{
+	case GYS_VECTOR_BOOL:   d.chars.insert(d.chars.begin()+pos, n, (char)(bool)v);   break;
+	case GYS_VECTOR_CHAR:   d.chars.insert(d.chars.begin()+pos, n, (char)v);         break;
+	case GYS_VECTOR_INT:    d.ints.insert(d.ints.begin()+pos, n, (int)v);            break;
+	case GYS_VECTOR_DOUBLE: d.doubles.insert(d.doubles.begin()+pos, n, (double)v);   break;
+	default:                d.vec.insert(d.vec.begin()+pos, n, v.get_value());
+	}
+}
+
+// moves unboxed elements into GYS_ret_val objects
+static void vector_box(GYS_vector_data& d, GYS_type_id type)
+{
+	unsigned n=vector_size(d);
+
+	d.vec.reserve(n);
+	for(unsigned i=0; i<n; i++)
+		d.vec.push_back(vector_elem(d, i, type));
+
+	vector<char>().swap(d.chars); // frees the arrays
+	vector<int>().swap(d.ints);
+	vector<double>().swap(d.doubles);
+
+	d.kind=GYS_VECTOR_BOXED;
+}
+
+// changes the element i (value of another type boxes the elements)
+static void vector_set(GYS_vector_data& d, unsigned i, GYS_ret_val v, GYS_type_id type)
+{
+	if(d.kind!=GYS_VECTOR_BOXED && v.get_type_id()!=type)
+		vector_box(d, type);
+
+	switch(d.kind)
+	{
+	case GYS_VECTOR_BOOL:   d.chars[i]=(bool)v;   break;
+	case GYS_VECTOR_CHAR:   d.chars[i]=(char)v;   break;
+	case GYS_VECTOR_INT:    d.ints[i]=(int)v;     break;
+	case GYS_VECTOR_DOUBLE: d.doubles[i]=(double)v; break;
+	default:                d.vec[i]=v.get_value();
+	}
+}
+
+// lvalue of unboxed element: it's read from the vector and its changes are written back (see GYS_vector_val::get_lvalue())
+class GYS_vector_elem_proxy: public GYS_user_val
+{
+private:
+	GYS_vector_val* vec; // isn't kept alive like the pointers to boxed elements
+	unsigned index;
+
+public:
+	GYS_ret_val val; // copy of the element
+
+	GYS_vector_elem_proxy(GYS_vector_val* v, unsigned i) : vec(v), index(i), val(v->at(i)) { }
+
+	string get_type_name() const {
+		return val.get_type_name();
+	}
+
+	GYS_type_id get_type_id() const {
+		return val.get_type_id();
+	}
+
+	void* get_user_val() {
+		return val.get_user_val();
+	}
+
+	void lvalue_changed() {
+		vec->set(index, val);
+	}
+
+	// the element may be changed through another lvalue
+	void lvalue_read() {
+		if(index<vec->size())
+			val=vec->at(index);
+	}
+};
+
+// erases n elements from the element pos
+static void vector_erase(GYS_vector_data& d, unsigned pos, unsigned n)
+{
+	switch(d.kind)
+	{
+	case GYS_VECTOR_BOOL:
+	case GYS_VECTOR_CHAR:   d.chars.erase(d.chars.begin()+pos, d.chars.begin()+pos+n);       break;
+	case GYS_VECTOR_INT:    d.ints.erase(d.ints.begin()+pos, d.ints.begin()+pos+n);          break;
+	case GYS_VECTOR_DOUBLE: d.doubles.erase(d.doubles.begin()+pos, d.doubles.begin()+pos+n); break;
+	default:                d.vec.erase(d.vec.begin()+pos, d.vec.begin()+pos+n);
+	}
+}
+
+//--------------------------element-wise operations-------------------------------
+// operations on double values like the operators of int and double do
+struct vector_add        { double operator()(double a, double b) const { return a+b; } };
+struct vector_sub        { double operator()(double a, double b) const { return a-b; } };
+struct vector_mul        { double operator()(double a, double b) const { return a*b; } };
+struct vector_div        { double operator()(double a, double b) const { return a/b; } };
+struct vector_less       { char operator()(double a, double b) const { return a<b; } };
+struct vector_greater    { char operator()(double a, double b) const { return a>b; } };
+struct vector_less_eq    { char operator()(double a, double b) const { return a<=b; } };
+struct vector_greater_eq { char operator()(double a, double b) const { return a>=b; } };
+struct vector_equal      { char operator()(double a, double b) const { return a==b; } };
+struct vector_not_equal  { char operator()(double a, double b) const { return a!=b; } };
+
+// kernel: plain loops over contiguous arrays (the compiler vectorizes them),
+// an array of one element is broadcast
+template<class L, class R, class Out, class F> static void vector_kernel(const L* a, unsigned na, const R* b, unsigned nb, vector<Out>& out, F f)
+{
+	unsigned n= na==1 ? nb : na;
+
+	out.resize(n);
+	if(n==0)
+		return;
+
+	Out* o=&out[0];
+
+	if(na==nb)
+		for(unsigned i=0; i<n; i++)
+			o[i]=f((double)a[i], (double)b[i]);
+	else if(na==1)
+	{
+		double x=a[0];
+		for(unsigned i=0; i<n; i++)
+			o[i]=f(x, (double)b[i]);
+	}
+	else
+	{
+		double y=b[0];
+		for(unsigned i=0; i<n; i++)
+			o[i]=f((double)a[i], y);
+	}
+}
+
+template<class L, class R> static void vector_kernel(GYS_vector_op op, const L* a, unsigned na, const R* b, unsigned nb, GYS_vector_data& out)
+{
+	switch(op)
+	{
+	case GYS_VECTOR_ADD:        vector_kernel(a, na, b, nb, out.doubles, vector_add());        break;
+	case GYS_VECTOR_SUB:        vector_kernel(a, na, b, nb, out.doubles, vector_sub());        break;
+	case GYS_VECTOR_MUL:        vector_kernel(a, na, b, nb, out.doubles, vector_mul());        break;
+	case GYS_VECTOR_DIV:        vector_kernel(a, na, b, nb, out.doubles, vector_div());        break;
+	case GYS_VECTOR_LESS:       vector_kernel(a, na, b, nb, out.chars, vector_less());         break;
+	case GYS_VECTOR_GREATER:    vector_kernel(a, na, b, nb, out.chars, vector_greater());      break;
+	case GYS_VECTOR_LESS_EQ:    vector_kernel(a, na, b, nb, out.chars, vector_less_eq());      break;
+	case GYS_VECTOR_GREATER_EQ: vector_kernel(a, na, b, nb, out.chars, vector_greater_eq());   break;
+	case GYS_VECTOR_EQUAL:      vector_kernel(a, na, b, nb, out.chars, vector_equal());        break;
+	case GYS_VECTOR_NOT_EQUAL:  vector_kernel(a, na, b, nb, out.chars, vector_not_equal());    break;
+	}
+}
+
+// int or double elements of a vector or its slice (see vector_numeric())
+struct GYS_vector_numeric
+{
+	GYS_vector_storage kind;    // GYS_VECTOR_INT or GYS_VECTOR_DOUBLE
+	const int*         ints;    // first element
+	const double*      doubles; // first element
+	unsigned           size;
+	vector<double>     copy;    // boxed elements converted into double
+};
+
+template<class L> static void vector_kernel(GYS_vector_op op, const L* a, unsigned na, const GYS_vector_numeric& r, GYS_vector_data& out)
+{
+	if(r.kind==GYS_VECTOR_INT)
+		vector_kernel(op, a, na, r.ints, r.size, out);
+	else
+		vector_kernel(op, a, na, r.doubles, r.size, out);
+}
+
+// n elements from the element pos (false if they aren't int or double)
+static bool vector_numeric(const GYS_vector_data& d, GYS_type_id type, unsigned pos, unsigned n, GYS_vector_numeric& num)
+{
+	GYS_vector_storage type_kind=vector_storage(type);
+	if(type_kind!=GYS_VECTOR_INT && type_kind!=GYS_VECTOR_DOUBLE) // not numeric
+		return false;
+
+	num.kind= d.kind==GYS_VECTOR_INT ? GYS_VECTOR_INT : GYS_VECTOR_DOUBLE;
+	num.ints= d.kind==GYS_VECTOR_INT && n ? &d.ints[pos] : 0;
+	num.doubles= d.kind==GYS_VECTOR_DOUBLE && n ? &d.doubles[pos] : 0;
+	num.size=n;
+
+	if(d.kind!=GYS_VECTOR_BOXED)
+		return true;
+
+	num.copy.reserve(n);
+	for(unsigned i=pos; i<pos+n; i++)
+	{
+		GYS_ret_val v=d.vec[i]; // assigned elements can have the other numeric type
+		GYS_vector_storage kind=vector_storage(v.get_type_id());
+
+		if(kind==GYS_VECTOR_INT)
+			num.copy.push_back((int)v);
+		else if(kind==GYS_VECTOR_DOUBLE)
+			num.copy.push_back((double)v);
+		else // not numeric
+			return false;
+	}
+
+	num.doubles= n ? &num.copy[0] : 0;
+	return true;
+}
+
+template<class T> static bool vector_has_zero(const T* a, unsigned n)
+{
+	for(unsigned i=0; i<n; i++)
+		if(a[i]==0)
+			return true;
+
+	return false;
+}
+
+//--------------------------reductions-------------------------------
+static const unsigned GYS_VECTOR_SUM_BLOCK=128; // elements summed in a loop by pairwise summation
+
+// terms of the sums
+template<class T> struct vector_term
+{
+	const T* a;
+	double operator()(unsigned i) const { return a[i]; }
+};
+
+template<class T> struct vector_square_dev
+{
+	const T* a;
+	double mean;
+	double operator()(unsigned i) const { double d=a[i]-mean; return d*d; }
+};
+
+template<class L, class R> struct vector_product
+{
+	const L* a;
+	const R* b;
+	double operator()(unsigned i) const { return (double)a[i]*(double)b[i]; }
+};
+
+// pairwise summation of f(i), i=from...from+n-1: the error grows as O(log n),
+// the order of additions depends only on n (the result is deterministic)
+template<class F> static double vector_pairwise_sum(unsigned from, unsigned n, const F& f)
+{
+	if(n>GYS_VECTOR_SUM_BLOCK)
+	{
+		unsigned half=n/2;
+		return vector_pairwise_sum(from, half, f)+vector_pairwise_sum(from+half, n-half, f);
+	}
+
+	// four independent sums (the compiler keeps them in registers)
+	double s0=0, s1=0, s2=0, s3=0;
+	unsigned i=from, end=from+n;
+
+	for(; i+4<=end; i+=4)
+	{
+		s0+=f(i);
+		s1+=f(i+1);
+		s2+=f(i+2);
+		s3+=f(i+3);
+	}
+	for(; i<end; i++)
+		s0+=f(i);
+
+	return (s0+s1)+(s2+s3);
+}
+
+template<class T> static double vector_reduce(GYS_vector_reduction op, const T* a, unsigned n)
+{
+	switch(op)
+	{
+	case GYS_VECTOR_ARGMIN:
+	case GYS_VECTOR_ARGMAX:
+		{
+			unsigned best=0;
+
+			for(unsigned i=1; i<n; i++)
+				if(op==GYS_VECTOR_ARGMIN ? a[i]<a[best] : a[i]>a[best])
+					best=i;
+
+			return best;
+		}
+
+	default:
+		{
+			vector_term<T> term={ a };
+			double sum=vector_pairwise_sum(0, n, term);
+
+			if(op==GYS_VECTOR_SUM)
+				return sum;
+
+			double mean=sum/n;
+			if(op==GYS_VECTOR_MEAN)
+				return mean;
+
+			vector_square_dev<T> dev={ a, mean }; // two passes are more accurate than sum of squares
+			return vector_pairwise_sum(0, n, dev)/n;
+		}
+	}
+}
+
+template<class L, class R> static double vector_dot(const L* a, const R* b, unsigned n)
+{
+	vector_product<L, R> product={ a, b };
+	return vector_pairwise_sum(0, n, product);
+}
+
+template<class L> static double vector_dot(const L* a, const GYS_vector_numeric& r)
+{
+	return r.kind==GYS_VECTOR_INT ? vector_dot(a, r.ints, r.size) : vector_dot(a, r.doubles, r.size);
+}
+
+GYS_vector_val::GYS_vector_val(string vtype)
+	: val_type(gys_type_id(vtype)), data(new GYS_vector_data(vector_storage(val_type))), offset(0), length(0), is_slice(false) {}
+
+GYS_vector_val::GYS_vector_val(GYS_type_id vtype)
+	: val_type(vtype), data(new GYS_vector_data(vector_storage(val_type))), offset(0), length(0), is_slice(false) {}
+
+GYS_vector_data& GYS_vector_val::own()
+{
+	if(is_slice) // copies only the elements of the slice
+	{
+		const GYS_vector_data& d=*data;
+		GYS_vector_data* own_data=new GYS_vector_data(d.kind);
+
+		switch(d.kind)
+		{
+		case GYS_VECTOR_BOOL:
+		case GYS_VECTOR_CHAR:   own_data->chars.assign(d.chars.begin()+offset, d.chars.begin()+offset+length);       break;
+		case GYS_VECTOR_INT:    own_data->ints.assign(d.ints.begin()+offset, d.ints.begin()+offset+length);          break;
+		case GYS_VECTOR_DOUBLE: own_data->doubles.assign(d.doubles.begin()+offset, d.doubles.begin()+offset+length); break;
+		default:                own_data->vec.assign(d.vec.begin()+offset, d.vec.begin()+offset+length);
+		}
+
+		data=own_data;
+		offset=length=0;
+		is_slice=false;
+	}
+	else if(data->getRefCnt()>1) // another copy shares the elements
+		data=new GYS_vector_data(*data);
+
+	return *data;
+}
+
+void GYS_vector_val::box()
+{
+	if(data->kind==GYS_VECTOR_BOXED)
+		return;
+
+	vector_box(own(), val_type);
+}
+
+void GYS_vector_val::unbox()
+{
+	if(data->kind==GYS_VECTOR_BOXED && data->vec.empty()) // there're no pointers to the elements
+		own().kind=vector_storage(val_type);
+}
 
 bool GYS_vector_val::push_back(GYS_ret_val v)	
 {
-	if(v.get_type_name()!=val_type ||  vec.size()>=vec.max_size())  // error
+	if(v.get_type_id()!=val_type ||  size()>=data->vec.max_size())  // error
 		return false;
 	
-	vec.push_back(v);
+	unbox();
+	vector_insert(own(), size(), 1, v);
 	return true;		
 }
 
 bool GYS_vector_val::pop_back()	
 {
-	if(vec.size()<1)  // error
+	if(size()<1)  // error
 		return false;
 		
-	vec.pop_back();
+	vector_erase(own(), size()-1, 1);
 
 	return true;		
 }
@@ -263,51 +680,238 @@ bool GYS_vector_val::pop_back()
 // inserts v before element vec[pos]
 bool GYS_vector_val::insert(unsigned int pos, GYS_ret_val v)	
 {
-	if(pos<0 || pos>vec.size() || v.get_type_name()!=val_type ||  vec.size()>=vec.max_size())  // error
+	if(pos<0 || pos>size() || v.get_type_id()!=val_type ||  size()>=data->vec.max_size())  // error
 		return false;
 	
-	vec.insert(&vec[pos], v);
+	unbox();
+	vector_insert(own(), pos, 1, v);
 	return true;		
 }
 
 bool GYS_vector_val::erase(unsigned int pos)	
 {
-	if(pos<0 || pos>=vec.size())  // error
+	if(pos<0 || pos>=size())  // error
 		return false;
 	
-	vec.erase(&vec[pos]);
+	vector_erase(own(), pos, 1);
 	return true;		
 }
 
 void GYS_vector_val::clear()
 {
-	vec.clear();
+	if(is_slice || data->getRefCnt()>1) // the copies keep their elements
+	{
+		data=new GYS_vector_data(vector_storage(val_type));
+		offset=length=0;
+		is_slice=false;
+	}
+	else
+	{
+		vector_erase(*data, 0, size());
+		unbox();
+	}
 }
 
 bool GYS_vector_val::resize(unsigned int n, GYS_ret_val def_val)
 {
-	if(n<0 || n>vec.max_size() || def_val.get_type_name()!=val_type) // error
+	if(n<0 || n>data->vec.max_size() || def_val.get_type_id()!=val_type) // error
 		return false;
 
-	vec.resize(n, def_val);
+	unsigned old_size=size();
+
+	if(n<old_size)
+		vector_erase(own(), n, old_size-n);
+	else if(n>old_size)
+	{
+		unbox();
+		vector_insert(own(), old_size, n-old_size, def_val);
+	}
 	
 	return true;
 }
 
 GYS_ret_val* GYS_vector_val::operator [](unsigned int index)
 {
-	if(index<0 || index>=vec.size()) // error
+	if(index<0 || index>=size()) // error
 		return 0;
 	
-	return &vec[index];
+	box();
+	return &own().vec[index];
+}
+
+GYS_ret_val GYS_vector_val::get_lvalue(unsigned int index)
+{
+	GYS_ret_val v;
+
+	if(index>=size()) // error
+		return v;
+
+	if(data->kind==GYS_VECTOR_BOXED)
+		return v.set_lvalue(&own().vec[index]);
+
+	// the elements are unshared when the proxy is changed
+	GYS_vector_elem_proxy* proxy=new GYS_vector_elem_proxy(this, index);
+	return v.set_lvalue(&proxy->val, proxy);
+}
+
+void GYS_vector_val::set(unsigned int index, const GYS_ret_val& v)
+{
+	if(index<size()) // the vector keeps its size
+		vector_set(own(), index, v, val_type);
+}
+
+GYS_ret_val GYS_vector_val::at(unsigned int index) const
+{
+	if(index<0 || index>=size()) // error
+		return GYS_ret_val();
+	
+	return vector_elem(*data, offset+index, val_type);
+}
+
+unsigned int GYS_vector_val::size() const
+{
+	return is_slice ? length : vector_size(*data);
+}
+
+bool GYS_vector_val::empty() const
+{
+	return size()==0;
 }
 
 vector<GYS_ret_val> GYS_vector_val::get_vector() const
 {
+	unsigned n=size();
+
+	if(data->kind==GYS_VECTOR_BOXED)
+		return vector<GYS_ret_val>(data->vec.begin()+offset, data->vec.begin()+offset+n);
+
+	vector<GYS_ret_val> vec;
+
+	vec.reserve(n);
+	for(unsigned i=0; i<n; i++)
+		vec.push_back(vector_elem(*data, offset+i, val_type));
+
 	return vec;
 }
 
+GYS_vector_val GYS_vector_val::slice(unsigned int pos, unsigned int n) const
+{
+	if(data->kind==GYS_VECTOR_BOXED) // assigned elements can have the other type, push_back() doesn't take them
+		for(unsigned i=offset+pos; i<offset+pos+n; i++)
+			if(data->vec[i].get_type_id()!=val_type)
+			{
+				GYS_vector_val s(val_type);
+				for(unsigned j=pos; j<pos+n; j++)
+					s.push_back(at(j));
+
+				return s;
+			}
+
+	GYS_vector_val s=*this; // shares the elements
+
+	s.offset=offset+pos;
+	s.length=n;
+	s.is_slice=true;
+
+	return s;
+}
+
+const double* GYS_vector_val::get_doubles() const
+{
+	if(data->kind!=GYS_VECTOR_DOUBLE || empty())
+		return 0;
+
+	return &data->doubles[offset];
+}
+
+double* GYS_vector_val::change_doubles()
+{
+	if(data->kind!=GYS_VECTOR_DOUBLE || empty())
+		return 0;
+
+	return &own().doubles[0]; // own elements start from 0
+}
+
+bool GYS_vector_val::elementwise(GYS_vector_op op, const GYS_vector_val& r, GYS_vector_val& result) const
+{
+	GYS_vector_numeric ln, rn;
+
+	if(!vector_numeric(*data, val_type, offset, size(), ln) || !vector_numeric(*r.data, r.val_type, r.offset, r.size(), rn))
+		return false;
+
+	if(ln.size!=rn.size && ln.size!=1 && rn.size!=1)
+		return false;
+
+	if(op==GYS_VECTOR_DIV && (rn.kind==GYS_VECTOR_INT ? vector_has_zero(rn.ints, rn.size) : vector_has_zero(rn.doubles, rn.size)))
+		return false;
+
+	bool compare= op!=GYS_VECTOR_ADD && op!=GYS_VECTOR_SUB && op!=GYS_VECTOR_MUL && op!=GYS_VECTOR_DIV;
+	GYS_vector_val out(compare ? gys_vector_bool_type : gys_vector_double_type);
+	GYS_vector_data& od=out.own();
+
+	if(ln.kind==GYS_VECTOR_INT)
+		vector_kernel(op, ln.ints, ln.size, rn, od);
+	else
+		vector_kernel(op, ln.doubles, ln.size, rn, od);
+
+	result=out;
+	return true;
+}
+
+bool GYS_vector_val::shares_values() const
+{
+	if(data->kind!=GYS_VECTOR_BOXED) // unboxed elements aren't shared
+		return false;
+
+	for(unsigned i=offset; i<offset+size(); i++)
+	{
+		GYS_user_val* v=data->vec[i].get_ptr_to_user_val();
+
+		if(v && (v->getRefCnt()>1 || v->shares_values()))
+			return true;
+	}
+
+	return false;
+}
+
+bool GYS_vector_val::is_numeric() const
+{
+	GYS_vector_numeric num;
+
+	return vector_numeric(*data, val_type, offset, size(), num);
+}
+
+bool GYS_vector_val::reduce(GYS_vector_reduction op, double& result) const
+{
+	GYS_vector_numeric num;
+
+	if(!vector_numeric(*data, val_type, offset, size(), num) || (op!=GYS_VECTOR_SUM && num.size==0))
+		return false;
+
+	result= num.kind==GYS_VECTOR_INT ? vector_reduce(op, num.ints, num.size) : vector_reduce(op, num.doubles, num.size);
+	return true;
+}
+
+bool GYS_vector_val::dot(const GYS_vector_val& r, double& result) const
+{
+	GYS_vector_numeric ln, rn;
+
+	if(!vector_numeric(*data, val_type, offset, size(), ln) || !vector_numeric(*r.data, r.val_type, r.offset, r.size(), rn))
+		return false;
+
+	if(ln.size!=rn.size)
+		return false;
+
+	result= ln.kind==GYS_VECTOR_INT ? vector_dot(ln.ints, rn) : vector_dot(ln.doubles, rn);
+	return true;
+}
+
 string GYS_vector_val::get_type_name() const
+{
+	return gys_type_name(val_type);
+}
+
+GYS_type_id GYS_vector_val::get_type_id() const
 {
 	return val_type;
 }
\ No newline at end of file
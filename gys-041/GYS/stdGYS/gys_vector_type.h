@@ -29,16 +29,80 @@
 
 #include "..\gys.h"
 
+//! Storage kinds of vector elements.
+enum GYS_vector_storage{
+	GYS_VECTOR_BOXED,  //!< GYS_ret_val elements (any type).
+	GYS_VECTOR_BOOL,   //!< Unboxed bool elements (in chars).
+	GYS_VECTOR_CHAR,   //!< Unboxed char elements (in chars).
+	GYS_VECTOR_INT,    //!< Unboxed int elements (in ints).
+	GYS_VECTOR_DOUBLE  //!< Unboxed double elements (in doubles).
+};
+
+//! Element-wise operations of numeric vectors (see GYS_vector_val::elementwise()).
+enum GYS_vector_op{
+	GYS_VECTOR_ADD,        //!< l[i]+r[i]
+	GYS_VECTOR_SUB,        //!< l[i]-r[i]
+	GYS_VECTOR_MUL,        //!< l[i]*r[i]
+	GYS_VECTOR_DIV,        //!< l[i]/r[i]
+	GYS_VECTOR_LESS,       //!< l[i]<r[i]
+	GYS_VECTOR_GREATER,    //!< l[i]>r[i]
+	GYS_VECTOR_LESS_EQ,    //!< l[i]<=r[i]
+	GYS_VECTOR_GREATER_EQ, //!< l[i]>=r[i]
+	GYS_VECTOR_EQUAL,      //!< l[i]==r[i]
+	GYS_VECTOR_NOT_EQUAL   //!< l[i]!=r[i]
+};
+
+//! Reductions of numeric vectors (see GYS_vector_val::reduce()).
+enum GYS_vector_reduction{
+	GYS_VECTOR_SUM,       //!< sum of the elements
+	GYS_VECTOR_MEAN,      //!< arithmetic mean
+	GYS_VECTOR_VARIANCE,  //!< population variance (mean of the squared deviations)
+	GYS_VECTOR_ARGMIN,    //!< index of the first minimal element
+	GYS_VECTOR_ARGMAX     //!< index of the first maximal element
+};
+
+//! Elements of vector values (shared by the copies of GYS_vector_val).
+/*!
+	Elements of bool, char, int and double are kept unboxed in contiguous arrays,
+	the others are kept in GYS_ret_val objects. Only one of the arrays is used.
+*/
+struct GYS_vector_data : public RefCntObject
+{
+	GYS_vector_storage  kind;    //!< which array keeps the elements
+	vector<GYS_ret_val> vec;     //!< boxed elements
+	vector<char>        chars;   //!< bool or char elements
+	vector<int>         ints;    //!< int elements
+	vector<double>      doubles; //!< double elements
+
+	GYS_vector_data(GYS_vector_storage storage=GYS_VECTOR_BOXED) : kind(storage) {}
+};
+
 //! Vector value.
 /*! 
 	Defined for use with GYS_ret_val to store stdGYS vectors
 	which can contain values of one type.
+	Copies share the elements (copying is O(1)), the elements are copied
+	when one of the copies is changed (copy-on-write).
+	Elements of primitive types are unboxed (see GYS_vector_data), they're boxed
+	when a pointer to an element is needed (see operator []()) or an element gets
+	the value of another type. get_lvalue() changes unboxed elements through a proxy.
+	Slice (see slice()) refers to the elements of its vector till one of them is changed.
 */
 class GYS_vector_val
 {
 private:
-	string val_type;
-	vector<GYS_ret_val> vec;
+	GYS_type_id val_type;
+	RefCntPointer<GYS_vector_data> data; // shared by the copies till one of them is changed
+	unsigned int offset;                 // first element of the slice
+	unsigned int length;                 // number of elements of the slice
+	bool is_slice;                       // only the elements [offset; offset+length) are used
+
+	GYS_vector_data& own(); // unshares the elements before changing them
+	void box();             // moves unboxed elements into GYS_ret_val objects
+	void unbox();           // empty vector keeps the next elements unboxed
+	void set(unsigned int index, const GYS_ret_val& v); // changes the element (see get_lvalue())
+
+	friend class GYS_vector_elem_proxy;
 
 public:
 	//! Constructor.
@@ -47,6 +111,12 @@ public:
     */
 	GYS_vector_val(string vtype=gys_void_type);
 
+	//! Constructor.
+    /*!
+      \param vtype type id of the contained values.
+    */
+	GYS_vector_val(GYS_type_id vtype);
+
 	//! Adds the new element to the end of the vector if it can contain the value of this type.
     /*!
       \param val new element to be inserted.
@@ -98,28 +168,147 @@ public:
     */
 	bool resize(unsigned int n, GYS_ret_val def_val);
 
-	//! Returns the pointer to the specified element.
+	//! Returns the pointer to the specified element (the element can be changed).
     /*!
+	  Unboxed elements are boxed once (the pointers are valid till the vector changes its size).
+
 	  \param index element's position.
 	  \return 0 - if failed, pointer to the element instead.
+
+	  \see at()
     */
 	GYS_ret_val* operator [](unsigned int index);
 
+	//! Returns the specified element as lvalue (the element can be changed).
+    /*!
+	  Unboxed elements aren't boxed, changes of the lvalue are written back into the element
+	  (see GYS_ret_val::set_lvalue()). The lvalue is valid till the vector is destroyed
+	  or changes its size.
+
+	  \param index element's position.
+	  \return Lvalue of the element, void value if the index is invalid.
+
+	  \see operator []()
+    */
+	GYS_ret_val get_lvalue(unsigned int index);
+
+	//! Returns the value of the specified element (the elements aren't unshared or boxed).
+    /*!
+	  \param index element's position.
+	  \return Value of the element, void value if the index is invalid.
+    */
+	GYS_ret_val at(unsigned int index) const;
+
+	//! Returns the number of elements.
+	unsigned int size() const;
+
+	//! Checks if the vector has no elements.
+	bool empty() const;
+
 	//! Returns the STL vector.
     /*!
+	  The elements are copied (boxed), use size() and at() to read them.
+
 	  \return The corresponding STL vector.
     */
 	vector<GYS_ret_val> get_vector() const;
 
+	//! Returns the slice of the vector without copying the elements.
+    /*!
+	  The slice keeps the elements of the vector alive, its own elements are made
+	  when one of them is changed (e.g. by push_back() or operator []()).
+
+	  \param pos index of the first element of the slice.
+	  \param n number of elements (pos+n mustn't exceed size()).
+	  \return The slice.
+    */
+	GYS_vector_val slice(unsigned int pos, unsigned int n) const;
+
+	//! Returns the unboxed double elements.
+    /*!
+	  \return Pointer to the first element, 0 if the vector has no unboxed double elements.
+
+	  \see change_doubles()
+    */
+	const double* get_doubles() const;
+
+	//! Returns the unboxed double elements which can be changed.
+    /*!
+	  The elements are unshared, the pointer is valid till the vector changes its size.
+
+	  \return Pointer to the first element, 0 if the vector has no unboxed double elements.
+    */
+	double* change_doubles();
+
+	//! Applies the element-wise operation to the elements of int or double vectors.
+    /*!
+	  The elements are computed as double values like the operators of int and double do
+	  (comparisons give bool elements). A vector of one element is broadcast to the size
+	  of the other vector (e.g. scalar converted into vector).
+
+	  \param op operation.
+	  \param r right operand.
+	  \param result gets the vector of double or bool elements.
+      \return <b>true</b> if function succeeded, <b>false</b> if the elements aren't int or double,
+	  the sizes differ or a divisor is 0.
+    */
+	bool elementwise(GYS_vector_op op, const GYS_vector_val& r, GYS_vector_val& result) const;
+
+	//! Checks if the elements are int or double values.
+    /*!
+      \return <b>true</b> if the elements can be used by elementwise(), reduce() and dot().
+    */
+	bool is_numeric() const;
+
+	//! Checks if the elements are shared with other values (e.g. "vector inner=v[0]").
+    /*!
+      \return <b>true</b> if an element or a value kept by an element is shared.
+    */
+	bool shares_values() const;
+
+	//! Reduces the elements of int or double vector to one value.
+    /*!
+	  Sums are computed pairwise in a fixed order, so the result depends only on the elements.
+
+	  \param op reduction.
+	  \param result gets the result.
+      \return <b>true</b> if function succeeded, <b>false</b> if the elements aren't int or double
+	  or the vector is empty (sum of no elements is 0).
+    */
+	bool reduce(GYS_vector_reduction op, double& result) const;
+
+	//! Computes the dot product of int or double vectors.
+    /*!
+	  \param r other vector.
+	  \param result gets the sum of l[i]*r[i] (computed pairwise).
+      \return <b>true</b> if function succeeded, <b>false</b> if the elements aren't int or double
+	  or the sizes differ.
+    */
+	bool dot(const GYS_vector_val& r, double& result) const;
+
 	//! Returns the typename of the contained values.
     /*!
 	  \return The typename of the values.
     */
 	string get_type_name() const;
+
+	//! Returns the type id of the contained values.
+    /*!
+	  \return The type id of the values.
+    */
+	GYS_type_id get_type_id() const;
 };
 
 static const char* gys_vector_type = "vector"; // vector stdGYS type
 
+// types of unboxed elements (store() of their stdGYS types mustn't be visible in the files of vector)
+static const char* gys_vector_bool_type   = "bool";
+static const char* gys_vector_char_type   = "char";
+static const char* gys_vector_double_type = "double";
+
+//! Returns double value (small value of gys_vector_double_type).
+GYS_ret_val gys_vector_double_val(double d);
+
 GYS_ret_val& store(GYS_ret_val& val, GYS_vector_val vector_user_val);
 
 // #type                       - empty vector
@@ -22,7 +22,8 @@ int main(int argc, char* argv[])
 		return 1;
 	}
 
-	bool nw=false, ne=false, nf=false;
+	bool nw=false, ne=false, nf=false, t=false, c=false, d=false, tm=false;
+	bool no_fold=false, no_branch=false, no_hoist=false, no_inline=false, no_tail_call=false;
 
 	// read keys
 	for(int i=1; i<argc; i++)
@@ -33,6 +34,24 @@ int main(int argc, char* argv[])
 			ne=true;
 		else if( !strcmp(argv[i], "-nf") ) // no fatal error messages
 			nf=true;
+		else if( !strcmp(argv[i], "-t") )  // token array mode
+			t=true;
+		else if( !strcmp(argv[i], "-c") )  // compiled mode
+			c=true;
+		else if( !strcmp(argv[i], "--dump-bytecode") ) // compiled mode, print the bytecode
+			c=d=true;
+		else if( !strcmp(argv[i], "--no-fold") )   // optimizer passes
+			no_fold=true;
+		else if( !strcmp(argv[i], "--no-branch") )
+			no_branch=true;
+		else if( !strcmp(argv[i], "--no-hoist") )
+			no_hoist=true;
+		else if( !strcmp(argv[i], "--no-inline") )
+			no_inline=true;
+		else if( !strcmp(argv[i], "--no-tail-call") )
+			no_tail_call=true;
+		else if( !strcmp(argv[i], "--time") )      // print time of interpreting
+			tm=true;
 		else
 			break;
 	}
@@ -58,6 +77,15 @@ int main(int argc, char* argv[])
 
 	s.set_input(&fin);           		
 
+	if(t) s.enable(GYS_PRETOKENIZE);
+	if(c) s.enable(GYS_COMPILE);
+	if(d) s.enable(GYS_DUMP_BYTECODE);
+	if(no_fold)   s.disable(GYS_OPT_FOLD);
+	if(no_branch) s.disable(GYS_OPT_BRANCH);
+	if(no_hoist)  s.disable(GYS_OPT_HOIST);
+	if(no_inline) s.disable(GYS_OPT_INLINE);
+	if(no_tail_call) s.disable(GYS_OPT_TAIL_CALL);
+
 	//init interpreter
 	if(!nw)	s.set_warning_func(std_gys_warning_callback);
 	if(!ne)	s.set_error_func(std_gys_error_callback);
@@ -77,17 +105,30 @@ int main(int argc, char* argv[])
 	// adding VERSION global const
 	s.add_global_var("@VERSION", "0.4.0");
 
+	clock_t start=clock();
+
 	s.interp(); //start interpreting
 	
 	cout<<endl<<s.get_name()<<" - "<<s.get_error_num()<<" error(s), "<<s.get_warning_num()<<" warning(s)"
 																		<<endl<<endl;
+	if(tm)
+		cerr<<"Time: "<<(double)(clock()-start)/CLOCKS_PER_SEC<<" s"<<endl;
 	return 0;
 }
 
 void usage()
 {
-	cerr<<"Usage:   gys [-nw -ne -nf] filename [arguments]"<<endl<<endl;
+	cerr<<"Usage:   gys [-nw -ne -nf -t -c --dump-bytecode --no-fold --no-branch --no-hoist --no-inline --no-tail-call --time] filename [arguments]"<<endl<<endl;
 	cerr<<"Options: -nw: no warning messages"<<endl;
 	cerr<<"         -ne: no error messages"<<endl;
-	cerr<<"         -nf: no fatal error messages"<<endl<<endl;
+	cerr<<"         -nf: no fatal error messages"<<endl;
+	cerr<<"         -t:  lex the script only once (token array mode)"<<endl;
+	cerr<<"         -c:  compile expressions on the first pass (compiled mode)"<<endl;
+	cerr<<"         --dump-bytecode: compiled mode, print the compiled bytecode"<<endl;
+	cerr<<"         --no-fold:   don't fold constant expressions (compiled mode)"<<endl;
+	cerr<<"         --no-branch: don't skip branches with constant conditions (compiled mode)"<<endl;
+	cerr<<"         --no-hoist:  don't hoist pure function calls out of loops (compiled mode)"<<endl;
+	cerr<<"         --no-inline: don't keep calls of small functions bound to their bodies (compiled mode)"<<endl;
+	cerr<<"         --no-tail-call: don't make tail calls of functions in the same call frame (compiled mode)"<<endl;
+	cerr<<"         --time: print the time of interpreting"<<endl<<endl;
 }
\ No newline at end of file
@@ -148,6 +148,141 @@ vector erase(vector vec, int pos);
 */
 vector clear(vector vec);
 
+//! Adds the elements of int or double vectors (element-wise).
+/*!
+  Vector of one element (or int or double value) is added to all the elements of the other vector.
+
+  \param l specified vector.
+  \param r specified vector.
+
+  \return New vector of double.
+
+  \see vsub(), vmul(), vdiv()
+*/
+vector vadd(vector l, vector r);
+
+vector vsub(vector l, vector r);
+vector vmul(vector l, vector r);
+vector vdiv(vector l, vector r);
+
+//! Compares the elements of int or double vectors (element-wise).
+/*!
+  Vector of one element (or int or double value) is compared with all the elements of the other vector.
+
+  \param l specified vector.
+  \param r specified vector.
+
+  \return New vector of bool (l[i]<r[i]).
+
+  \see vgreater(), vless_eq(), vgreater_eq(), vequal(), vnot_equal()
+*/
+vector vless(vector l, vector r);
+
+vector vgreater(vector l, vector r);
+vector vless_eq(vector l, vector r);
+vector vgreater_eq(vector l, vector r);
+vector vequal(vector l, vector r);
+vector vnot_equal(vector l, vector r);
+
+//! Sums the elements of int or double vector.
+/*!
+  The sum is computed pairwise, the result depends only on the elements.
+
+  \param vec specified vector.
+
+  \return Sum of the elements (0 for empty vector).
+
+  \see vmean(), vvariance(), vdot()
+*/
+double vsum(vector vec);
+
+//! Gets the arithmetic mean of the elements of int or double vector (it can't be empty).
+double vmean(vector vec);
+
+//! Gets the population variance of the elements of int or double vector (it can't be empty).
+double vvariance(vector vec);
+
+//! Gets the minimal element of int or double vector.
+/*!
+  \param vec specified vector (can't be empty).
+
+  \return Minimal element.
+
+  \see vargmin(), vmax()
+*/
+some_type vmin(vector vec);
+
+some_type vmax(vector vec);
+
+//! Gets the index of the first minimal element of int or double vector.
+/*!
+  \param vec specified vector (can't be empty).
+
+  \return Index of the element.
+
+  \see vmin(), vargmax()
+*/
+int vargmin(vector vec);
+
+int vargmax(vector vec);
+
+//! Gets the dot product of int or double vectors of the same size.
+double vdot(vector l, vector r);
+
+//! Gets the number of rows of the matrix.
+int mrows(matrix m);
+
+//! Gets the number of columns of the matrix.
+int mcols(matrix m);
+
+//! Changes the element of the matrix.
+/*!
+  \param m specified matrix (must be lvalue).
+  \param i row of the element.
+  \param j column of the element.
+  \param val new value.
+
+  \return New matrix.
+*/
+matrix mset(matrix m, int i, int j, double val);
+
+//! Gets the transposed matrix.
+matrix mtranspose(matrix m);
+
+//! Multiplies all the elements of the matrix by the number.
+matrix mscale(matrix m, double k);
+
+//! Multiplies the elements of matrices of the same size (element-wise).
+/*!
+  \param l specified matrix.
+  \param r specified matrix.
+
+  \return New matrix (l[i][j]*r[i][j]).
+
+  \see mdiv_elems()
+*/
+matrix mmul_elems(matrix l, matrix r);
+
+matrix mdiv_elems(matrix l, matrix r);
+
+//! Sums the elements of each row of the matrix.
+/*!
+  \param m specified matrix.
+
+  \return New vector of double (one element for each row).
+
+  \see mcol_sums(), mrow_means()
+*/
+vector mrow_sums(matrix m);
+
+vector mcol_sums(matrix m);
+
+//! Gets the arithmetic means of the rows of the matrix.
+vector mrow_means(matrix m);
+
+//! Gets the arithmetic means of the columns of the matrix.
+vector mcol_means(matrix m);
+
 //! Prints specified string.
 /*!
   \param str string to be printed.
@@ -464,7 +599,7 @@ This statement doesn't have its own local scope.
 			- +
 			- * (e.g. "xyz"*3=="xyzxyzxyz")
 			- *=
-			- +=
+			- += (appends in place if no other variable shares the string)
 			- == != < > <= >=
 			- "const" [] </tt>
 
@@ -474,7 +609,15 @@ This statement doesn't have its own local scope.
 			- []
 			- +
 			- += </tt>
-		- postfix range operator: <tt> vector(low~up) </tt>
+		- postfix range operator: <tt> vector(low~up) </tt> (slice, the elements are copied when one of them is changed)
+
+	- <b>matrix</b> (of double, e.g. <tt> {{1, 2}, {3, 4}} </tt> or <tt> [rows, cols]:val </tt>):
+		- binary:
+			- <tt> =
+			- [] (row as vector, e.g. m[i][j])
+			- + - (element-wise)
+			- * (matrix product) </tt>
+		- postfix range operator: <tt> matrix(low~up) </tt> (rows, the elements aren't copied)
 
 	- <b>function</b>:
 		- binary:
@@ -530,6 +673,10 @@ This statement doesn't have its own local scope.
 	- <tt> vector -> string! (using conversions) </tt>
 			
 	- <tt> string -> vector of char </tt>
+
+	- <tt> matrix -> vector of vectors of double (rows)
+	- vector -> matrix (vector of rows or vector of numbers as one row)
+	- matrix -> string </tt>
 */
 
 #endif
\ No newline at end of file